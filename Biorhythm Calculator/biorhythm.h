@@ -0,0 +1,394 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../common/csv_writer.h"
+#include "../common/progress.h"
+#ifndef CSV_MANAGER_NO_XLSX
+#include "../common/xlsx_reader.h"
+#include "../common/xlsx_writer.h"
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Biorhythm core shared by the Win32 GUI (main.cpp) and the console tool
+// (cli.cpp). Counts rows through a Progress; it never touches a window.
+
+// Biorhythm calculation structure
+struct BiorhythmResult {
+    double physical;
+    double emotional;
+    double intellectual;
+    double spiritual;
+    double awareness;
+    double intuitive;
+    double aesthetic;
+};
+
+// Data structures
+struct BiorhythmData {
+    std::vector<std::vector<std::string>> data;
+    std::vector<std::string> headers;
+    std::string filePath;
+    std::string folderPath;
+    std::string dobColumn;
+    std::string dateColumn;
+    std::vector<std::string> biorhythmColumns = {"Emotional", "Physical", "Intellectual", "Spiritual", "Awareness", "Intuitive", "Aesthetic"};
+};
+
+// Reads a date in one of the formats below without a stream: %Y takes up
+// to 4 digits, %m and %d up to 2 and are range-checked, a space matches any
+// run of whitespace and other characters must match exactly. Trailing text
+// is ignored, as with std::get_time.
+inline bool parseDate(const std::string& text, const char* format, std::tm& out) {
+    std::tm parsed = {};
+    const char* p = text.data();
+    const char* end = p + text.size();
+    for (const char* f = format; *f; ++f) {
+        if (*f == ' ') {
+            while (p < end && std::isspace(static_cast<unsigned char>(*p))) ++p;
+            continue;
+        }
+        if (*f != '%') {
+            if (p == end || *p != *f) return false;
+            ++p;
+            continue;
+        }
+        ++f;
+        int max_digits = *f == 'Y' ? 4 : 2;
+        int value = 0, digits = 0;
+        while (p < end && digits < max_digits && *p >= '0' && *p <= '9') {
+            value = value * 10 + (*p++ - '0');
+            ++digits;
+        }
+        if (digits == 0) return false;
+        if (*f == 'Y') {
+            parsed.tm_year = value - 1900;
+        }
+        else if (*f == 'm') {
+            if (value < 1 || value > 12) return false;
+            parsed.tm_mon = value - 1;
+        }
+        else {
+            if (value < 1 || value > 31) return false;
+            parsed.tm_mday = value;
+        }
+    }
+    out = parsed;
+    return true;
+}
+
+// Biorhythm calculation function
+inline BiorhythmResult calculateBiorhythm(const std::string& birthDateStr, const std::string& targetDateStr) {
+    BiorhythmResult result = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    
+    try {
+        // Parse dates with multiple format support
+        std::tm birthDate = {}, targetDate = {};
+        bool parseSuccess = false;
+        
+        // Try multiple date formats
+        std::vector<std::pair<std::string, std::string>> dateFormats = {
+            {"%Y-%m-%d", "YYYY-MM-DD"},           // 1991-12-14
+            {"%m/%d/%Y", "M/D/YYYY"},             // 12/14/1991
+            {"%d/%m/%Y", "DD/MM/YYYY"},           // 14/12/1991
+            {"%Y/%m/%d", "YYYY/MM/DD"},           // 1991/12/14
+            {"%m-%d-%Y", "MM-DD-YYYY"},           // 12-14-1991
+            {"%d-%m-%Y", "DD-MM-YYYY"},           // 14-12-1991
+            {"%Y.%m.%d", "YYYY.MM.DD"},           // 1991.12.14
+            {"%m.%d.%Y", "MM.DD.YYYY"},           // 12.14.1991
+            {"%d.%m.%Y", "DD.MM.YYYY"},           // 14.12.1991
+            {"%Y %m %d", "YYYY MM DD"},           // 1991 12 14
+            {"%m %d %Y", "MM DD YYYY"},           // 12 14 1991
+            {"%d %m %Y", "DD MM YYYY"}            // 14 12 1991
+        };
+        
+        for (const auto& format : dateFormats) {
+            if (parseDate(birthDateStr, format.first.c_str(), birthDate) &&
+                parseDate(targetDateStr, format.first.c_str(), targetDate)) {
+                parseSuccess = true;
+                break;
+            }
+        }
+        
+        if (!parseSuccess) {
+            return result; // Return zeros if all parsing attempts fail
+        }
+        
+        // Convert to time_t
+        std::time_t birthTime = std::mktime(&birthDate);
+        std::time_t targetTime = std::mktime(&targetDate);
+        
+        if (birthTime == -1 || targetTime == -1) {
+            return result;
+        }
+        
+        // Calculate days since birth
+        double daysSinceBirth = std::difftime(targetTime, birthTime) / (24 * 60 * 60);
+        
+        // Biorhythm cycles (constants)
+        const double EMOTIONAL_CYCLE = 28.0;
+        const double PHYSICAL_CYCLE = 23.0;
+        const double INTELLECTUAL_CYCLE = 33.0;
+        const double SPIRITUAL_CYCLE = 53.0;
+        const double AWARENESS_CYCLE = 48.0;
+        const double INTUITIVE_CYCLE = 38.0;
+        const double AESTHETIC_CYCLE = 43.0;
+        
+        // Calculate each biorhythm value with rounding
+        result.emotional = std::round(std::sin(2.0 * M_PI * daysSinceBirth / EMOTIONAL_CYCLE) * 100.0);
+        result.physical = std::round(std::sin(2.0 * M_PI * daysSinceBirth / PHYSICAL_CYCLE) * 100.0);
+        result.intellectual = std::round(std::sin(2.0 * M_PI * daysSinceBirth / INTELLECTUAL_CYCLE) * 100.0);
+        result.spiritual = std::round(std::sin(2.0 * M_PI * daysSinceBirth / SPIRITUAL_CYCLE) * 100.0);
+        result.awareness = std::round(std::sin(2.0 * M_PI * daysSinceBirth / AWARENESS_CYCLE) * 100.0);
+        result.intuitive = std::round(std::sin(2.0 * M_PI * daysSinceBirth / INTUITIVE_CYCLE) * 100.0);
+        result.aesthetic = std::round(std::sin(2.0 * M_PI * daysSinceBirth / AESTHETIC_CYCLE) * 100.0);
+        
+    } catch (...) {
+        return result; // Return zeros if any error occurs
+    }
+    
+    return result;
+}
+
+// Helper function to convert Excel column letter to 0-based index
+inline int columnLetterToIndex(const std::string& columnLetter) {
+    int result = 0;
+    for (char c : columnLetter) {
+        if (c >= 'A' && c <= 'Z') {
+            result = result * 26 + (c - 'A' + 1);
+        } else if (c >= 'a' && c <= 'z') {
+            result = result * 26 + (c - 'a' + 1);
+        }
+    }
+    return result - 1; // Convert to 0-based index
+}
+
+// CSV/Excel file manager
+class FileManager {
+public:
+    static bool readFile(const std::string& filePath, BiorhythmData& data) {
+        std::filesystem::path path(filePath);
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        
+        if (extension == ".csv") {
+            return readCSVFile(filePath, data);
+        } else if (extension == ".xlsx" || extension == ".xls") {
+            return readExcelFile(filePath, data);
+        }
+        return false;
+    }
+    
+    static void writeFile(const BiorhythmData& data, const std::string& filePath) {
+        std::filesystem::path path(filePath);
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        
+        if (extension == ".csv") {
+            writeCSVFile(data, filePath);
+        } else if (extension == ".xlsx" || extension == ".xls") {
+            writeExcelFile(data, filePath);
+        } else {
+            throw std::runtime_error("Unsupported file type");
+        }
+    }
+
+private:
+    static bool readCSVFile(const std::string& filePath, BiorhythmData& data) {
+        std::ifstream file(filePath);
+        if (!file.is_open()) return false;
+        
+        data.data.clear();
+        data.headers.clear();
+        
+        std::string line;
+        
+        while (std::getline(file, line)) {
+            std::vector<std::string> row;
+            std::stringstream ss(line);
+            std::string cell;
+            
+            while (std::getline(ss, cell, ',')) {
+                // Remove quotes and trim whitespace
+                cell.erase(std::remove(cell.begin(), cell.end(), '"'), cell.end());
+                cell.erase(0, cell.find_first_not_of(" \t"));
+                cell.erase(cell.find_last_not_of(" \t") + 1);
+                row.push_back(cell);
+            }
+            
+            if (!row.empty()) {
+                data.data.push_back(row);
+            }
+        }
+        
+        // Generate default headers based on column count
+        if (!data.data.empty()) {
+            size_t maxCols = 0;
+            for (const auto& row : data.data) {
+                maxCols = std::max(maxCols, row.size());
+            }
+            
+            for (size_t i = 0; i < maxCols; ++i) {
+                std::string colName = "C_" + std::to_string(i + 1);
+                data.headers.push_back(colName);
+            }
+        }
+        
+        return true;
+    }
+    
+#ifndef CSV_MANAGER_NO_XLSX
+    static bool readExcelFile(const std::string& filePath, BiorhythmData& data) {
+        try {
+            data.data.clear();
+            data.headers.clear();
+            
+            for (auto& rowData : XlsxReader::read(filePath)) {
+                if (!rowData.empty()) {
+                    data.data.push_back(std::move(rowData));
+                }
+            }
+            
+            // Generate default headers based on column count
+            if (!data.data.empty()) {
+                size_t maxCols = 0;
+                for (const auto& row : data.data) {
+                    maxCols = std::max(maxCols, row.size());
+                }
+                
+                for (size_t i = 0; i < maxCols; ++i) {
+                    std::string colName = "C_" + std::to_string(i + 1);
+                    data.headers.push_back(colName);
+                }
+            }
+            
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+    
+#else
+    static bool readExcelFile(const std::string&, BiorhythmData&) {
+        return false;
+    }
+#endif
+    
+    static void writeCSVFile(const BiorhythmData& data, const std::string& filePath) {
+        CsvWriter writer(filePath);
+        
+        // Write headers
+        writer.writeRow(data.headers);
+        
+        // Write data
+        for (const auto& row : data.data) {
+            writer.writeRow(row);
+        }
+        
+        writer.close();
+    }
+    
+    static void writeExcelFile([[maybe_unused]] const BiorhythmData& data, [[maybe_unused]] const std::string& filePath) {
+#ifndef CSV_MANAGER_NO_XLSX
+        XlsxWriter writer(filePath);
+        
+        // Write headers
+        writer.writeRow(data.headers);
+        
+        // Write data
+        for (const auto& row : data.data) {
+            writer.writeRow(row);
+        }
+        
+        writer.close();
+#else
+        throw std::runtime_error("XLSX support is not built in");
+#endif
+    }
+};
+
+// Output next to the input: <file>_with_biorhythms.csv for .csv input,
+// .xlsx otherwise
+inline std::string biorhythmOutputPath(const std::string& filePath) {
+    std::filesystem::path inputPath(filePath);
+    std::string extension = inputPath.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    
+    std::string outputPath;
+    if (extension == ".csv") {
+        outputPath = filePath.substr(0, filePath.find_last_of('.')) + "_with_biorhythms.csv";
+    } else {
+        outputPath = filePath.substr(0, filePath.find_last_of('.')) + "_with_biorhythms.xlsx";
+    }
+    return outputPath;
+}
+
+// Appends the seven biorhythm columns (or refreshes them when the headers
+// already have them) from the dates in columns dobIdx and dateIdx. Counts
+// rows through progress.addDone().
+inline void addBiorhythms(BiorhythmData& data, size_t dobIdx, size_t dateIdx, Progress& progress) {
+    // Add biorhythm column headers if they don't exist
+    bool needHeaders = true;
+    for (const auto& header : data.headers) {
+        if (header == "Emotional" || header == "Physical" || header == "Intellectual") {
+            needHeaders = false;
+            break;
+        }
+    }
+    
+    if (needHeaders) {
+        data.headers.insert(data.headers.end(), 
+            data.biorhythmColumns.begin(), data.biorhythmColumns.end());
+    }
+    
+    // Process each row
+    for (size_t i = 0; i < data.data.size(); ++i) {
+        // Get DOB and target date from the row
+        if (dobIdx < data.data[i].size() && dateIdx < data.data[i].size()) {
+            std::string birthDate = data.data[i][dobIdx];
+            std::string targetDate = data.data[i][dateIdx];
+
+            // Calculate biorhythm
+            BiorhythmResult biorhythm = calculateBiorhythm(birthDate, targetDate);
+            
+            // Add biorhythm values to the row
+            if (needHeaders) {
+                // Add new columns for biorhythm values
+                data.data[i].push_back(std::to_string(static_cast<int>(biorhythm.emotional)));
+                data.data[i].push_back(std::to_string(static_cast<int>(biorhythm.physical)));
+                data.data[i].push_back(std::to_string(static_cast<int>(biorhythm.intellectual)));
+                data.data[i].push_back(std::to_string(static_cast<int>(biorhythm.spiritual)));
+                data.data[i].push_back(std::to_string(static_cast<int>(biorhythm.awareness)));
+                data.data[i].push_back(std::to_string(static_cast<int>(biorhythm.intuitive)));
+                data.data[i].push_back(std::to_string(static_cast<int>(biorhythm.aesthetic)));
+            } else {
+                // Update existing biorhythm columns
+                size_t baseIdx = data.headers.size() - 7;
+                if (data.data[i].size() <= baseIdx) {
+                    data.data[i].resize(baseIdx + 7);
+                }
+                data.data[i][baseIdx] = std::to_string(static_cast<int>(biorhythm.emotional));
+                data.data[i][baseIdx + 1] = std::to_string(static_cast<int>(biorhythm.physical));
+                data.data[i][baseIdx + 2] = std::to_string(static_cast<int>(biorhythm.intellectual));
+                data.data[i][baseIdx + 3] = std::to_string(static_cast<int>(biorhythm.spiritual));
+                data.data[i][baseIdx + 4] = std::to_string(static_cast<int>(biorhythm.awareness));
+                data.data[i][baseIdx + 5] = std::to_string(static_cast<int>(biorhythm.intuitive));
+                data.data[i][baseIdx + 6] = std::to_string(static_cast<int>(biorhythm.aesthetic));
+            }
+        }
+        progress.addDone();
+    }
+}
@@ -0,0 +1,77 @@
+// Console front end of the biorhythm calculator, for batch servers and cron.
+//
+// biorhythm --input FILE [--dob-column B] [--date-column P] [--output FILE] [--quiet]
+
+#include <iostream>
+#include <string>
+#include "../common/cli_args.h"
+#include "../common/console_progress.h"
+#include "../common/progress.h"
+#include "biorhythm.h"
+
+namespace {
+
+const char* kUsage =
+    "Usage: biorhythm --input FILE [options]\n"
+    "\n"
+    "Adds the seven biorhythm columns to every row of a .csv/.xlsx file, from\n"
+    "the birth date and target date columns.\n"
+    "\n"
+    "Options:\n"
+    "  --dob-column COL   birth date column letter (default B)\n"
+    "  --date-column COL  target date column letter (default P)\n"
+    "  --output FILE      output file (default <input>_with_biorhythms.<ext>)\n"
+    "  --quiet            no progress on stderr\n";
+
+std::string formatProgress(const Progress::Snapshot& shot) {
+    if (shot.total == 0) return {};
+    return "Processing row " + std::to_string(shot.done) + "/" + std::to_string(shot.total);
+}
+
+size_t columnArg(const CliArgs& args, const std::string& name, const std::string& fallback, size_t columns) {
+    std::string letter = args.get(name, fallback);
+    int index = columnLetterToIndex(letter);
+    if (index < 0) throw UsageError("Not a column letter for " + name + ": " + letter);
+    if (static_cast<size_t>(index) >= columns) throw std::runtime_error("Column " + letter + " is past the last column of the file");
+    return static_cast<size_t>(index);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        CliArgs args(argc, argv, { "--input", "--dob-column", "--date-column", "--output" }, { "--quiet" });
+        if (args.flag("--help")) {
+            std::cout << kUsage;
+            return 0;
+        }
+        BiorhythmData data;
+        std::string input = args.require("--input");
+        if (!FileManager::readFile(input, data)) {
+            throw std::runtime_error("Could not load file: " + input);
+        }
+        data.filePath = input;
+        size_t dobIdx = columnArg(args, "--dob-column", "B", data.headers.size());
+        size_t dateIdx = columnArg(args, "--date-column", "P", data.headers.size());
+        std::string outputPath = args.get("--output", biorhythmOutputPath(input));
+
+        Progress progress;
+        progress.start(data.data.size());
+        ConsoleProgress reporter(progress, formatProgress, !args.flag("--quiet"));
+        addBiorhythms(data, dobIdx, dateIdx, progress);
+        FileManager::writeFile(data, outputPath);
+        progress.finish();
+        reporter.stop();
+
+        std::cout << "Processing completed successfully! Output saved to: " << outputPath << std::endl;
+        return 0;
+    }
+    catch (const UsageError& e) {
+        std::cerr << e.what() << "\n\n" << kUsage;
+        return 2;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
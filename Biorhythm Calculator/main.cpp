@@ -4,17 +4,11 @@
 #include <commctrl.h>
 #include <string>
 #include <vector>
-#include <iostream>
-#include <fstream>
-#include <sstream>
-#include <algorithm>
 #include <filesystem>
 #include <thread>
-#include <memory>
-#include <xlnt/xlnt.hpp>
-#include <cmath>
-#include <chrono>
-#define M_PI 3.14159265358979323846
+#include "../common/progress.h"
+#include "biorhythm.h"
+#define IDT_PROGRESS 100
 
 // Forward declarations
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
@@ -33,282 +27,11 @@ HWND hStartButton;
 HWND hStatusText;
 HWND hProgressBar;
 
-// Biorhythm calculation structure
-struct BiorhythmResult {
-    double physical;
-    double emotional;
-    double intellectual;
-    double spiritual;
-    double awareness;
-    double intuitive;
-    double aesthetic;
-};
-
-// Data structures
-struct BiorhythmData {
-    std::vector<std::vector<std::string>> data;
-    std::vector<std::string> headers;
-    std::string filePath;
-    std::string folderPath;
-    std::string dobColumn;
-    std::string dateColumn;
-    std::vector<std::string> biorhythmColumns = {"Emotional", "Physical", "Intellectual", "Spiritual", "Awareness", "Intuitive", "Aesthetic"};
-};
+// Rows done by the worker, shown by the UI timer
+Progress progress;
 
 BiorhythmData biorhythmData;
 
-// Biorhythm calculation function
-BiorhythmResult calculateBiorhythm(const std::string& birthDateStr, const std::string& targetDateStr) {
-    BiorhythmResult result = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
-    
-    try {
-        // Parse dates with multiple format support
-        std::tm birthDate = {}, targetDate = {};
-        bool parseSuccess = false;
-        
-        // Try multiple date formats
-        std::vector<std::pair<std::string, std::string>> dateFormats = {
-            {"%Y-%m-%d", "YYYY-MM-DD"},           // 1991-12-14
-            {"%m/%d/%Y", "M/D/YYYY"},             // 12/14/1991
-            {"%d/%m/%Y", "DD/MM/YYYY"},           // 14/12/1991
-            {"%Y/%m/%d", "YYYY/MM/DD"},           // 1991/12/14
-            {"%m-%d-%Y", "MM-DD-YYYY"},           // 12-14-1991
-            {"%d-%m-%Y", "DD-MM-YYYY"},           // 14-12-1991
-            {"%Y.%m.%d", "YYYY.MM.DD"},           // 1991.12.14
-            {"%m.%d.%Y", "MM.DD.YYYY"},           // 12.14.1991
-            {"%d.%m.%Y", "DD.MM.YYYY"},           // 14.12.1991
-            {"%Y %m %d", "YYYY MM DD"},           // 1991 12 14
-            {"%m %d %Y", "MM DD YYYY"},           // 12 14 1991
-            {"%d %m %Y", "DD MM YYYY"}            // 14 12 1991
-        };
-        
-        for (const auto& format : dateFormats) {
-            std::istringstream birthStream(birthDateStr);
-            std::istringstream targetStream(targetDateStr);
-            
-            // Reset tm structures
-            birthDate = {};
-            targetDate = {};
-            
-            birthStream >> std::get_time(&birthDate, format.first.c_str());
-            targetStream >> std::get_time(&targetDate, format.first.c_str());
-            
-            if (!birthStream.fail() && !targetStream.fail()) {
-                parseSuccess = true;
-                break;
-            }
-        }
-        
-        if (!parseSuccess) {
-            return result; // Return zeros if all parsing attempts fail
-        }
-        
-        // Convert to time_t
-        std::time_t birthTime = std::mktime(&birthDate);
-        std::time_t targetTime = std::mktime(&targetDate);
-        
-        if (birthTime == -1 || targetTime == -1) {
-            return result;
-        }
-        
-        // Calculate days since birth
-        double daysSinceBirth = std::difftime(targetTime, birthTime) / (24 * 60 * 60);
-        
-        // Biorhythm cycles (constants)
-        const double EMOTIONAL_CYCLE = 28.0;
-        const double PHYSICAL_CYCLE = 23.0;
-        const double INTELLECTUAL_CYCLE = 33.0;
-        const double SPIRITUAL_CYCLE = 53.0;
-        const double AWARENESS_CYCLE = 48.0;
-        const double INTUITIVE_CYCLE = 38.0;
-        const double AESTHETIC_CYCLE = 43.0;
-        
-        // Calculate each biorhythm value with rounding
-        result.emotional = std::round(std::sin(2.0 * M_PI * daysSinceBirth / EMOTIONAL_CYCLE) * 100.0);
-        result.physical = std::round(std::sin(2.0 * M_PI * daysSinceBirth / PHYSICAL_CYCLE) * 100.0);
-        result.intellectual = std::round(std::sin(2.0 * M_PI * daysSinceBirth / INTELLECTUAL_CYCLE) * 100.0);
-        result.spiritual = std::round(std::sin(2.0 * M_PI * daysSinceBirth / SPIRITUAL_CYCLE) * 100.0);
-        result.awareness = std::round(std::sin(2.0 * M_PI * daysSinceBirth / AWARENESS_CYCLE) * 100.0);
-        result.intuitive = std::round(std::sin(2.0 * M_PI * daysSinceBirth / INTUITIVE_CYCLE) * 100.0);
-        result.aesthetic = std::round(std::sin(2.0 * M_PI * daysSinceBirth / AESTHETIC_CYCLE) * 100.0);
-        
-    } catch (...) {
-        return result; // Return zeros if any error occurs
-    }
-    
-    return result;
-}
-
-// Helper function to convert Excel column letter to 0-based index
-int columnLetterToIndex(const std::string& columnLetter) {
-    int result = 0;
-    for (char c : columnLetter) {
-        if (c >= 'A' && c <= 'Z') {
-            result = result * 26 + (c - 'A' + 1);
-        } else if (c >= 'a' && c <= 'z') {
-            result = result * 26 + (c - 'a' + 1);
-        }
-    }
-    return result - 1; // Convert to 0-based index
-}
-
-// CSV/Excel file manager
-class FileManager {
-public:
-    static bool readFile(const std::string& filePath, BiorhythmData& data) {
-        std::filesystem::path path(filePath);
-        std::string extension = path.extension().string();
-        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-        
-        if (extension == ".csv") {
-            return readCSVFile(filePath, data);
-        } else if (extension == ".xlsx" || extension == ".xls") {
-            return readExcelFile(filePath, data);
-        }
-        return false;
-    }
-    
-    static void writeFile(const BiorhythmData& data, const std::string& filePath) {
-        std::filesystem::path path(filePath);
-        std::string extension = path.extension().string();
-        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-        
-        if (extension == ".csv") {
-            writeCSVFile(data, filePath);
-        } else if (extension == ".xlsx" || extension == ".xls") {
-            writeExcelFile(data, filePath);
-        }
-    }
-
-private:
-    static bool readCSVFile(const std::string& filePath, BiorhythmData& data) {
-        std::ifstream file(filePath);
-        if (!file.is_open()) return false;
-        
-        data.data.clear();
-        data.headers.clear();
-        
-        std::string line;
-        
-        while (std::getline(file, line)) {
-            std::vector<std::string> row;
-            std::stringstream ss(line);
-            std::string cell;
-            
-            while (std::getline(ss, cell, ',')) {
-                // Remove quotes and trim whitespace
-                cell.erase(std::remove(cell.begin(), cell.end(), '"'), cell.end());
-                cell.erase(0, cell.find_first_not_of(" \t"));
-                cell.erase(cell.find_last_not_of(" \t") + 1);
-                row.push_back(cell);
-            }
-            
-            if (!row.empty()) {
-                data.data.push_back(row);
-            }
-        }
-        
-        // Generate default headers based on column count
-        if (!data.data.empty()) {
-            size_t maxCols = 0;
-            for (const auto& row : data.data) {
-                maxCols = std::max(maxCols, row.size());
-            }
-            
-            for (size_t i = 0; i < maxCols; ++i) {
-                std::string colName = "C_" + std::to_string(i + 1);
-                data.headers.push_back(colName);
-            }
-        }
-        
-        return true;
-    }
-    
-    static bool readExcelFile(const std::string& filePath, BiorhythmData& data) {
-        try {
-            xlnt::workbook wb;
-            wb.load(filePath);
-            auto ws = wb.active_sheet();
-            
-            data.data.clear();
-            data.headers.clear();
-            
-            for (auto row : ws.rows(false)) {
-                std::vector<std::string> rowData;
-                for (auto cell : row) {
-                    rowData.push_back(cell.to_string());
-                }
-                
-                if (!rowData.empty()) {
-                    data.data.push_back(rowData);
-                }
-            }
-            
-            // Generate default headers based on column count
-            if (!data.data.empty()) {
-                size_t maxCols = 0;
-                for (const auto& row : data.data) {
-                    maxCols = std::max(maxCols, row.size());
-                }
-                
-                for (size_t i = 0; i < maxCols; ++i) {
-                    std::string colName = "C_" + std::to_string(i + 1);
-                    data.headers.push_back(colName);
-                }
-            }
-            
-            return true;
-        } catch (...) {
-            return false;
-        }
-    }
-    
-    static void writeCSVFile(const BiorhythmData& data, const std::string& filePath) {
-        std::ofstream file(filePath);
-        if (!file.is_open()) return;
-        
-        // Write headers
-        for (size_t i = 0; i < data.headers.size(); ++i) {
-            if (i > 0) file << ",";
-            file << "\"" << data.headers[i] << "\"";
-        }
-        file << "\n";
-        
-        // Write data
-        for (const auto& row : data.data) {
-            for (size_t i = 0; i < row.size(); ++i) {
-                if (i > 0) file << ",";
-                file << "\"" << row[i] << "\"";
-            }
-            file << "\n";
-        }
-    }
-    
-    static void writeExcelFile(const BiorhythmData& data, const std::string& filePath) {
-        try {
-            xlnt::workbook wb;
-            auto ws = wb.active_sheet();
-            
-            // Write headers
-            for (size_t i = 0; i < data.headers.size(); ++i) {
-                ws.cell(static_cast<uint32_t>(i + 1), 1).value(data.headers[i]);
-            }
-            
-            // Write data
-            for (size_t rowIdx = 0; rowIdx < data.data.size(); ++rowIdx) {
-                const auto& row = data.data[rowIdx];
-                for (size_t colIdx = 0; colIdx < row.size(); ++colIdx) {
-                    ws.cell(static_cast<uint32_t>(colIdx + 1), static_cast<uint32_t>(rowIdx + 2)).value(row[colIdx]);
-                }
-            }
-            
-            wb.save(filePath);
-        } catch (...) {
-            // Handle error
-        }
-    }
-};
-
 // UI Helper functions
 void updateColumnDropdowns() {
     // Clear existing items
@@ -390,6 +113,18 @@ void OnBrowseFile() {
     }
 }
 
+// Shows the rows done so far; called from the UI timer
+void ShowProgress(HWND hwnd) {
+    Progress::Snapshot shot = progress.snapshot();
+    if (shot.finished) {
+        KillTimer(hwnd, IDT_PROGRESS);
+        return;
+    }
+    std::string progressStatus = "Processing row " + std::to_string(shot.done) + "/" + std::to_string(shot.total);
+    SetWindowTextA(hStatusText, progressStatus.c_str());
+    SendMessage(hProgressBar, PBM_SETPOS, shot.done, 0);
+}
+
 void OnStartProcessing() {
     if (biorhythmData.data.empty()) {
         SetWindowTextA(hStatusText, "Error: No file loaded");
@@ -419,90 +154,25 @@ void OnStartProcessing() {
     // Set progress bar
     SendMessage(hProgressBar, PBM_SETRANGE, 0, MAKELPARAM(0, biorhythmData.data.size()));
     SendMessage(hProgressBar, PBM_SETPOS, 0, 0);
+    progress.start(biorhythmData.data.size());
+    SetTimer(hMainWindow, IDT_PROGRESS, 100, nullptr);
     
     // Process biorhythms in a separate thread
     std::thread([=]() {
         try {
-            // Add biorhythm column headers if they don't exist
-            bool needHeaders = true;
-            for (const auto& header : biorhythmData.headers) {
-                if (header == "Emotional" || header == "Physical" || header == "Intellectual") {
-                    needHeaders = false;
-                    break;
-                }
-            }
-            
-            if (needHeaders) {
-                biorhythmData.headers.insert(biorhythmData.headers.end(), 
-                    biorhythmData.biorhythmColumns.begin(), biorhythmData.biorhythmColumns.end());
-            }
-            
-            // Process each row
-            for (size_t i = 0; i < biorhythmData.data.size(); ++i) {
-                // Update progress
-                SendMessage(hProgressBar, PBM_SETPOS, i + 1, 0);
-                
-                // Update status
-                std::string progressStatus = "Processing row " + std::to_string(i + 1) + "/" + std::to_string(biorhythmData.data.size());
-                SetWindowTextA(hStatusText, progressStatus.c_str());
-                
-                // Get DOB and target date from the row
-                if (dobIdx < biorhythmData.data[i].size() && dateIdx < biorhythmData.data[i].size()) {
-                    std::string birthDate = biorhythmData.data[i][dobIdx];
-                    std::string targetDate = biorhythmData.data[i][dateIdx];
-
-                    // Calculate biorhythm
-                    BiorhythmResult biorhythm = calculateBiorhythm(birthDate, targetDate);
-                    
-                    // Add biorhythm values to the row
-                    if (needHeaders) {
-                        // Add new columns for biorhythm values
-                        biorhythmData.data[i].push_back(std::to_string(static_cast<int>(biorhythm.emotional)));
-                        biorhythmData.data[i].push_back(std::to_string(static_cast<int>(biorhythm.physical)));
-                        biorhythmData.data[i].push_back(std::to_string(static_cast<int>(biorhythm.intellectual)));
-                        biorhythmData.data[i].push_back(std::to_string(static_cast<int>(biorhythm.spiritual)));
-                        biorhythmData.data[i].push_back(std::to_string(static_cast<int>(biorhythm.awareness)));
-                        biorhythmData.data[i].push_back(std::to_string(static_cast<int>(biorhythm.intuitive)));
-                        biorhythmData.data[i].push_back(std::to_string(static_cast<int>(biorhythm.aesthetic)));
-                    } else {
-                        // Update existing biorhythm columns
-                        size_t baseIdx = biorhythmData.headers.size() - 7;
-                        if (biorhythmData.data[i].size() <= baseIdx) {
-                            biorhythmData.data[i].resize(baseIdx + 7);
-                        }
-                        biorhythmData.data[i][baseIdx] = std::to_string(static_cast<int>(biorhythm.emotional));
-                        biorhythmData.data[i][baseIdx + 1] = std::to_string(static_cast<int>(biorhythm.physical));
-                        biorhythmData.data[i][baseIdx + 2] = std::to_string(static_cast<int>(biorhythm.intellectual));
-                        biorhythmData.data[i][baseIdx + 3] = std::to_string(static_cast<int>(biorhythm.spiritual));
-                        biorhythmData.data[i][baseIdx + 4] = std::to_string(static_cast<int>(biorhythm.awareness));
-                        biorhythmData.data[i][baseIdx + 5] = std::to_string(static_cast<int>(biorhythm.intuitive));
-                        biorhythmData.data[i][baseIdx + 6] = std::to_string(static_cast<int>(biorhythm.aesthetic));
-                    }
-                }
-                
-                // Small delay to prevent UI freezing
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            }
+            addBiorhythms(biorhythmData, dobIdx, dateIdx, progress);
             
             // Save the updated data
-            std::filesystem::path inputPath(biorhythmData.filePath);
-            std::string extension = inputPath.extension().string();
-            std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-            
-            std::string outputPath;
-            if (extension == ".csv") {
-                outputPath = biorhythmData.filePath.substr(0, biorhythmData.filePath.find_last_of('.')) + "_with_biorhythms.csv";
-            } else {
-                outputPath = biorhythmData.filePath.substr(0, biorhythmData.filePath.find_last_of('.')) + "_with_biorhythms.xlsx";
-            }
-            
+            std::string outputPath = biorhythmOutputPath(biorhythmData.filePath);
             FileManager::writeFile(biorhythmData, outputPath);
             
             // Processing complete
+            progress.finish();
             std::string completeStatus = "Processing completed successfully! Output saved to: " + outputPath;
             SetWindowTextA(hStatusText, completeStatus.c_str());
             
         } catch (const std::exception& e) {
+            progress.finish();
             std::string errorStatus = "Error during processing: " + std::string(e.what());
             SetWindowTextA(hStatusText, errorStatus.c_str());
         }
@@ -600,6 +270,10 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
         break;
     }
     
+    case WM_TIMER:
+        if (wParam == IDT_PROGRESS) ShowProgress(hwnd);
+        break;
+    
     case WM_DESTROY:
         PostQuitMessage(0);
         break;
@@ -0,0 +1,453 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cwctype>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <iterator>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../common/column_projection.h"
+#include "../common/combination_counter.h"
+#include "../common/csv_manager.h"
+#include "../common/csv_writer.h"
+#include "../common/progress.h"
+#include "../common/thread_pool.h"
+
+// Counting core shared by the Win32 GUI (main.cpp) and the console tool
+// (cli.cpp). Reports through a Progress and the console log; it never
+// touches a window.
+
+// Files are processed concurrently, so every console line goes out whole
+inline void logLine(const std::string& line) {
+    static std::mutex console_mutex;
+    std::lock_guard<std::mutex> lock(console_mutex);
+    std::cout << line << std::endl;
+}
+
+// Available columns for selection (equivalent to Python COLUMN_MAPPING)
+const std::map<std::string, int> COLUMN_MAPPING = {
+    {"AQ", 42}, {"AS", 44}, {"AU", 46}, {"AW", 48}, {"AY", 50}, {"BA", 52},
+    {"BC", 54}, {"BE", 56}, {"BG", 58}, {"BI", 60}, {"BK", 62}
+};
+
+// Structure to hold combination data
+struct Combination {
+    std::string col_name;
+    int col_index;
+};
+
+// Generate combinations (equivalent to Python itertools.combinations)
+inline std::vector<std::vector<Combination>> generateCombinations(int set_size) {
+    std::vector<std::vector<Combination>> result;
+    std::vector<Combination> items;
+    
+    for (const auto& pair : COLUMN_MAPPING) {
+        items.push_back({pair.first, pair.second});
+    }
+    
+    if (static_cast<size_t>(set_size) > items.size()) return result;
+    
+    std::vector<bool> mask(items.size(), false);
+    std::fill(mask.begin(), mask.begin() + set_size, true);
+    
+    do {
+        std::vector<Combination> combination;
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (mask[i]) {
+                combination.push_back(items[i]);
+            }
+        }
+        result.push_back(combination);
+    } while (std::prev_permutation(mask.begin(), mask.end()));
+    
+    return result;
+}
+
+// Mapped column positions of a combination, as CombinationCounter takes them
+inline std::vector<size_t> combinationSlots(const std::vector<Combination>& combination) {
+    std::vector<size_t> slots;
+    for (const auto& combo : combination) {
+        slots.push_back(static_cast<size_t>(std::distance(COLUMN_MAPPING.begin(), COLUMN_MAPPING.find(combo.col_name))));
+    }
+    return slots;
+}
+
+// Writes the output rows of one combination's groups (equivalent to the
+// Python process_file). The columns are written as the string key
+// "player|value|..." used to split back: columns past the end of a short
+// row are left out and an empty last value is dropped.
+inline void writeGroups(CsvWriter& writer, const EncodedRows& rows, const std::vector<Combination>& combination,
+                        const std::vector<size_t>& slots, const std::vector<CountedGroup>& groups, size_t set_size) {
+    for (const CountedGroup& group : groups) {
+        size_t present = 0;
+        while (present < combination.size() && group.key.codes[present + 1] != EncodedRows::kMissing) present++;
+        if (present > 0 && rows.value(slots[present - 1], group.key.codes[present]).empty()) present--;
+        if (present == 0) continue;
+        
+        int over = group.counts.over;
+        int total = group.counts.over + group.counts.under;
+        
+        // Calculate count (sum of degree values)
+        int row_sum = 0;
+        for (size_t i = 1; i <= present; ++i) {
+            row_sum += rows.valueInt(slots[i - 1], group.key.codes[i]);
+        }
+        
+        writer.field(rows.player(group.key.codes[0]));
+        for (size_t i = 1; i <= set_size; ++i) {
+            if (i <= present) {
+                writer.field(combination[i - 1].col_name);
+                writer.field(rows.value(slots[i - 1], group.key.codes[i]));
+            }
+            else {
+                writer.field(std::string_view());
+                writer.field(std::string_view());
+            }
+        }
+        writer.field(row_sum);
+        writer.field(total);
+        writer.field(over);
+        writer.field(std::round((double)over / total * 100.0) / 100.0, 2);
+        writer.endRow();
+    }
+}
+
+// Set size that writes every set size, 3 to 8, in one run
+constexpr int kAllSetSizes = 0;
+
+// One set size of a run and its combinations; write is false for a size
+// only counted to prune the next
+struct SetSize {
+    int set_size;
+    std::vector<std::vector<Combination>> combinations;
+    bool write;
+};
+
+// The set sizes a run counts, in counting order. Without pruning they are
+// the sizes written, largest first so that every size after the first can
+// be rolled up from the one before. With a min_support above 1 they go up
+// from a single column, each size pruning the next.
+inline std::vector<SetSize> planSetSizes(int set_size, int min_support) {
+    std::vector<SetSize> sizes;
+    int largest = set_size == kAllSetSizes ? 8 : set_size;
+    int smallest = set_size == kAllSetSizes ? 3 : set_size;
+    if (min_support > 1) {
+        for (int size = 1; size <= largest; ++size) {
+            sizes.push_back({ size, generateCombinations(size), size >= smallest });
+        }
+    }
+    else {
+        for (int size = largest; size >= smallest; --size) {
+            sizes.push_back({ size, generateCombinations(size), true });
+        }
+    }
+    return sizes;
+}
+
+// Groups of one set size kept to roll up the next smaller one. A
+// combination's groups are kept when there are fewer of them than rows,
+// the only case where summing them beats counting the rows, and while
+// the kept total stays under kMaxGroups.
+struct RollUpSource {
+    static constexpr size_t kMaxGroups = size_t(1) << 20;
+
+    std::vector<std::vector<size_t>> slots;
+    std::vector<std::vector<CountedGroup>> groups;
+    std::vector<bool> kept;
+    std::vector<size_t> by_mask; // combination of a column bit mask, or npos
+    size_t total = 0;
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    static uint32_t maskOf(const std::vector<size_t>& slots) {
+        uint32_t mask = 0;
+        for (size_t slot : slots) mask |= uint32_t(1) << slot;
+        return mask;
+    }
+
+    explicit RollUpSource(std::vector<std::vector<size_t>> combination_slots = {})
+        : slots(std::move(combination_slots)), groups(slots.size()), kept(slots.size(), false),
+          by_mask(size_t(1) << COLUMN_MAPPING.size(), npos) {
+        for (size_t c = 0; c < slots.size(); ++c) by_mask[maskOf(slots[c])] = c;
+    }
+
+    void keep(size_t combination, std::vector<CountedGroup>& combination_groups, size_t row_count) {
+        if (combination_groups.size() >= row_count || total + combination_groups.size() > kMaxGroups) return;
+        total += combination_groups.size();
+        groups[combination] = std::move(combination_groups);
+        kept[combination] = true;
+    }
+
+    // The kept combination with one column more than child_slots and the
+    // fewest groups, or npos
+    size_t parentOf(const std::vector<size_t>& child_slots) const {
+        uint32_t mask = maskOf(child_slots);
+        size_t best = npos;
+        for (size_t slot = 0; slot < COLUMN_MAPPING.size(); ++slot) {
+            if (mask & (uint32_t(1) << slot)) continue;
+            size_t parent = by_mask[mask | (uint32_t(1) << slot)];
+            if (parent == npos || !kept[parent]) continue;
+            if (best == npos || groups[parent].size() < groups[best].size()) best = parent;
+        }
+        return best;
+    }
+};
+
+// Outcome of one input file, as the line logged for it
+struct FileResult {
+    std::string message;
+    bool ok;
+};
+
+// Process file wrapper (equivalent to Python process_file_wrapper). The
+// file is read once for every size. Without pruning, each size after the
+// first rolls its combinations up from the groups of the size before
+// where it can; with a min_support above 1, groups below it are left out
+// and each size skips the rows the size before left below it. Batches of
+// combinations run on pool; output does not depend on its size.
+inline FileResult processFileWrapper(const std::filesystem::path& input_path, 
+                              const std::vector<SetSize>& sizes,
+                              int min_support,
+                              const std::filesystem::path& output_dir,
+                              size_t file_index,
+                              ThreadPool& pool,
+                              Progress& progress) {
+    try {
+        std::string filename = input_path.filename().u8string();
+        logLine("→ " + filename + " started");
+        
+        // Only Player, the result column and the mapped columns are read
+        ColumnProjection projection{0, 7};
+        std::vector<int> columns;
+        for (const auto& column : COLUMN_MAPPING) {
+            projection.add(column.second);
+            columns.push_back(column.second);
+        }
+        progress.setCurrentFile(file_index);
+        progress.addBytes(std::filesystem::file_size(input_path));
+        EncodedRows rows(CSVManager::read(input_path, projection), 7, columns);
+        progress.addRows(rows.size());
+        
+        bool pruned = min_support > 1;
+        size_t written = static_cast<size_t>(std::count_if(sizes.begin(), sizes.end(), [](const SetSize& size) { return size.write; }));
+        RollUpSource parents;
+        std::unique_ptr<RowSupport> below;
+        std::vector<uint32_t> below_masks;
+        for (const SetSize& size : sizes) {
+            const auto& combinations = size.combinations;
+            size_t set_size = static_cast<size_t>(size.set_size);
+            if (size.write && written > 1) logLine("  Set size " + std::to_string(set_size));
+            
+            std::vector<std::vector<size_t>> slots;
+            std::vector<uint32_t> masks;
+            for (const auto& combination : combinations) {
+                slots.push_back(combinationSlots(combination));
+                masks.push_back(RollUpSource::maskOf(slots.back()));
+            }
+            CombinationCounter counter(rows, slots);
+            RollUpSource kept(slots);
+            
+            SupportPruning pruning;
+            std::unique_ptr<RowSupport> reached;
+            if (pruned) {
+                pruning.min_support = min_support;
+                pruning.below = below.get();
+                if (below) pruning.subsets = subsetIndices(masks, below_masks);
+                if (&size != &sizes.back()) {
+                    reached = std::make_unique<RowSupport>(rows.size(), combinations.size());
+                    pruning.reached = reached.get();
+                }
+                counter.prune(&pruning);
+            }
+            
+            // The file is created with its first output row
+            std::string base_name = input_path.stem().u8string();
+            std::string output_name = base_name + "_Size_" + std::to_string(set_size) + "_Degree_YES.csv";
+            std::filesystem::path output_path = output_dir / std::filesystem::u8path(output_name);
+            std::unique_ptr<CsvWriter> writer;
+            
+            // One pool task per batch of combinations counts (or rolls up)
+            // the batch and formats its rows into its own buffer. Buffers
+            // are written, and groups kept, in combination order, with a
+            // few batches per worker in flight.
+            struct BatchOutput {
+                std::vector<std::vector<CountedGroup>> groups;
+                std::string csv;
+            };
+            bool keep_groups = !pruned && &size != &sizes.back();
+            auto run_batch = [&](size_t first, size_t last) {
+                BatchOutput output;
+                
+                // Roll up what the larger size kept; count the rest in one pass
+                output.groups.resize(last - first);
+                std::vector<size_t> counted;
+                for (size_t comb_id = first; comb_id < last; ++comb_id) {
+                    size_t parent = parents.parentOf(slots[comb_id]);
+                    if (parent == RollUpSource::npos) counted.push_back(comb_id);
+                    else output.groups[comb_id - first] = counter.rollUp(comb_id, parents.slots[parent], parents.groups[parent]);
+                }
+                if (!counted.empty()) {
+                    auto counted_groups = counter.countBatch(counted);
+                    for (size_t i = 0; i < counted.size(); ++i) output.groups[counted[i] - first] = std::move(counted_groups[i]);
+                }
+                
+                if (size.write) {
+                    CsvWriter rows_out;
+                    for (size_t comb_id = first; comb_id < last; ++comb_id) {
+                        const auto& groups = output.groups[comb_id - first];
+                        writeGroups(rows_out, rows, combinations[comb_id], slots[comb_id], groups, set_size);
+                    }
+                    output.csv = rows_out.take();
+                }
+                if (!keep_groups) output.groups.clear();
+                progress.addDone(last - first);
+                return output;
+            };
+            
+            size_t batch_count = (combinations.size() + CombinationCounter::kBatchSize - 1) / CombinationCounter::kBatchSize;
+            size_t window = pool.size() * 2;
+            size_t submitted = 0;
+            std::deque<std::future<BatchOutput>> in_flight;
+            try {
+                for (size_t b = 0; b < batch_count; ++b) {
+                    for (; submitted < batch_count && submitted <= b + window; ++submitted) {
+                        size_t first = submitted * CombinationCounter::kBatchSize;
+                        size_t last = std::min(combinations.size(), first + CombinationCounter::kBatchSize);
+                        in_flight.push_back(pool.submit([&run_batch, first, last] { return run_batch(first, last); }));
+                    }
+                    BatchOutput output = pool.wait(in_flight.front());
+                    in_flight.pop_front();
+                    
+                    size_t first = b * CombinationCounter::kBatchSize;
+                    size_t last = std::min(combinations.size(), first + CombinationCounter::kBatchSize);
+                    for (size_t comb_id = first; comb_id < last && size.write; ++comb_id) {
+                        std::string combo_line = "  Combo " + std::to_string(comb_id + 1) + "/" + std::to_string(combinations.size()) + ": ";
+                        for (const auto& combo : combinations[comb_id]) {
+                            combo_line += combo.col_name + " ";
+                        }
+                        logLine(combo_line);
+                    }
+                    if (!writer && !output.csv.empty()) {
+                        writer = std::make_unique<CsvWriter>(output_path);
+                        
+                        // Header row
+                        Row header = {"Player"};
+                        for (size_t i = 1; i <= set_size; ++i) {
+                            header.push_back("Col_" + std::to_string(i));
+                            header.push_back("Val_" + std::to_string(i));
+                        }
+                        header.insert(header.end(), {"Count", "MATCH TOTAL", "WIN TOTAL", "WIN% OVER"});
+                        writer->writeRow(header);
+                    }
+                    if (writer) writer->append(output.csv);
+                    if (keep_groups) {
+                        for (size_t comb_id = first; comb_id < last; ++comb_id) kept.keep(comb_id, output.groups[comb_id - first], rows.size());
+                    }
+                }
+            }
+            catch (...) {
+                // The batches still in flight use this frame
+                for (auto& future : in_flight) {
+                    try { pool.wait(future); } catch (...) {}
+                }
+                throw;
+            }
+            parents = std::move(kept);
+            below = std::move(reached);
+            below_masks = std::move(masks);
+            
+            if (writer) {
+                writer->close();
+                logLine("✓ Saved to " + output_path.u8string());
+            }
+        }
+        
+        return { filename + " completed", true };
+    } catch (const std::exception& e) {
+        return { input_path.u8string() + " failed: " + e.what(), false };
+    }
+}
+
+
+// Output folder of a run: <input folder>_output
+inline std::filesystem::path defaultOutputDir(const std::filesystem::path& input_dir) {
+    std::filesystem::path output_dir = input_dir;
+    output_dir += "_output";
+    return output_dir;
+}
+
+// Counts every combination of set_size mapped columns in every .csv/.xlsx
+// file of input_dir, one output file per input file in output_dir; with
+// kAllSetSizes, one output file per input file and set size 3 to 8.
+// Groups with fewer than min_support rows are left out (0 or 1 keeps all).
+// Files, and the combination batches within each file, run as tasks on one
+// pool of threads workers (0 for all cores). Returns the outcome of every
+// file in directory order; an empty result means there was nothing to
+// process.
+inline std::vector<FileResult> ProcessBulkFiles(const std::filesystem::path& input_dir, int set_size, int min_support,
+                                                 const std::filesystem::path& output_dir, size_t threads,
+                                                 Progress& progress) {
+    progress.setStatus("Generating combinations...");
+    
+    // Generate combinations
+    auto sizes = planSetSizes(set_size, min_support);
+    size_t combination_count = 0;
+    for (const SetSize& size : sizes) combination_count += size.combinations.size();
+    if (combination_count == 0) {
+        throw std::runtime_error("No combinations generated for the selected set size.");
+    }
+    
+    // Get list of files to process
+    std::vector<std::filesystem::path> files_to_process;
+    for (const auto& entry : std::filesystem::directory_iterator(input_dir)) {
+        if (!entry.is_regular_file()) continue;
+        
+        std::wstring filename = entry.path().filename().wstring();
+        std::wstring ext = entry.path().extension().wstring();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::towlower);
+        
+        if ((ext == L".xlsx" && filename.find(L"~$") != 0) || ext == L".csv") {
+            files_to_process.push_back(entry.path());
+        }
+    }
+    if (files_to_process.empty()) return {};
+    
+    // Create output directory
+    std::filesystem::create_directories(output_dir);
+    
+    size_t total_work = files_to_process.size() * combination_count;
+    progress.setStatus("Processing " + std::to_string(files_to_process.size()) + " files with " +
+                       std::to_string(combination_count) + " combinations each (" +
+                       std::to_string(total_work) + " total operations)");
+    
+    // Process files, one pool task per file; every file writes its own
+    // output, and results are reported in directory order
+    std::vector<std::string> file_names;
+    for (const auto& file_path : files_to_process) {
+        file_names.push_back(file_path.filename().u8string());
+    }
+    progress.setFiles(std::move(file_names));
+    progress.setTotal(total_work);
+    ThreadPool pool(threads);
+    std::vector<std::future<FileResult>> file_results;
+    for (size_t file_index = 0; file_index < files_to_process.size(); ++file_index) {
+        const auto& file_path = files_to_process[file_index];
+        file_results.push_back(pool.submit([&, file_path, file_index]() {
+            return processFileWrapper(file_path, sizes, min_support, output_dir, file_index, pool, progress);
+        }));
+    }
+    std::vector<FileResult> results;
+    for (size_t file_index = 0; file_index < files_to_process.size(); ++file_index) {
+        results.push_back(pool.wait(file_results[file_index]));
+        logLine(results.back().message);
+    }
+    return results;
+}
@@ -0,0 +1,88 @@
+// Console front end of the bulk counter, for batch servers and cron.
+//
+// counter --input FOLDER [--output FOLDER] [--set-size 3..8|all] [--min-support N]
+//         [--threads N] [--quiet]
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "../common/cli_args.h"
+#include "../common/console_progress.h"
+#include "../common/progress.h"
+#include "bulk_counter.h"
+
+namespace {
+
+const char* kUsage =
+    "Usage: counter --input FOLDER [options]\n"
+    "\n"
+    "Counts every combination of the mapped columns in each .csv/.xlsx file\n"
+    "of FOLDER and writes one <file>_Size_<n>_Degree_YES.csv per file.\n"
+    "With --set-size all every file is read once for all six set sizes.\n"
+    "\n"
+    "Options:\n"
+    "  --output FOLDER    output folder (default <input>_output)\n"
+    "  --set-size N       columns per combination, 3 to 8, or all (default 3)\n"
+    "  --min-support N    leave out groups with a MATCH TOTAL below N; larger\n"
+    "                     set sizes skip what smaller ones left out (default 1)\n"
+    "  --threads N        worker threads, 0 for all cores (default 0)\n"
+    "  --quiet            no progress on stderr\n";
+
+std::string formatProgress(const Progress::Snapshot& shot) {
+    if (shot.total == 0) return shot.status;
+    std::string text = "Processing: " + shot.current + " - " + std::to_string(shot.done) + "/" +
+        std::to_string(shot.total) + " combinations (" + std::to_string(shot.percent()) + "%)";
+    double eta = shot.etaSeconds();
+    if (eta >= 0) {
+        int eta_seconds = static_cast<int>(eta);
+        text += " - ETA: " + std::to_string(eta_seconds / 60) + "m " + std::to_string(eta_seconds % 60) + "s";
+    }
+    return text;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        CliArgs args(argc, argv, { "--input", "--output", "--set-size", "--min-support", "--threads" }, { "--quiet" });
+        if (args.flag("--help")) {
+            std::cout << kUsage;
+            return 0;
+        }
+        std::filesystem::path input_dir = std::filesystem::u8path(args.require("--input"));
+        std::filesystem::path output_dir = args.has("--output") ? std::filesystem::u8path(args.get("--output")) : defaultOutputDir(input_dir);
+        int set_size = args.get("--set-size") == "all" ? kAllSetSizes : args.getInt("--set-size", 3);
+        if (set_size != kAllSetSizes && (set_size < 3 || set_size > 8)) throw UsageError("--set-size must be between 3 and 8, or all");
+        int min_support = args.getInt("--min-support", 1);
+        if (min_support < 0) throw UsageError("--min-support must not be negative");
+
+        auto start_time = std::chrono::steady_clock::now();
+        Progress progress;
+        progress.start();
+        ConsoleProgress reporter(progress, formatProgress, !args.flag("--quiet"));
+        std::vector<FileResult> results = ProcessBulkFiles(input_dir, set_size, min_support, output_dir, args.threads(), progress);
+        progress.finish();
+        reporter.stop();
+
+        if (results.empty()) {
+            std::cout << "No valid files found to process." << std::endl;
+            return 0;
+        }
+        auto total_seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start_time).count();
+        std::cout << "Processing finished in " << total_seconds / 60 << "m " << total_seconds % 60 << "s. Output saved in: "
+            << output_dir.u8string() << std::endl;
+        // A file that failed fails the run, so cron reports it
+        for (const FileResult& result : results) {
+            if (!result.ok) return 1;
+        }
+        return 0;
+    }
+    catch (const UsageError& e) {
+        std::cerr << e.what() << "\n\n" << kUsage;
+        return 2;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
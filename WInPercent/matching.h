@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cwctype>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../common/csv_manager.h"
+#include "../common/match_writer.h"
+#include "../common/numeric_parse.h"
+#include "../common/progress.h"
+#include "../common/thread_pool.h"
+
+// Matching core shared by the Win32 GUI (main.cpp) and the console tool
+// (cli.cpp). Reports through a Progress and throws on errors; it never
+// touches a window.
+
+// Helper: filter daily data to columns 0 and 41-62
+inline DataFrame FilterDailyData(const DataFrame& raw_daily_df) {
+    DataFrame filtered_data;
+    for (const Row& row : raw_daily_df) {
+        Row filtered_row;
+        if (!row.empty()) filtered_row.push_back(row[0]);
+        for (int i = 41; i <= 62 && i < static_cast<int>(row.size()); ++i) {
+            filtered_row.push_back(row[i]);
+        }
+        if (!filtered_row.empty()) filtered_data.push_back(filtered_row);
+    }
+    return filtered_data;
+}
+
+// Daily degree values parsed once: 22 per row in daily_cols order, 0 where
+// the cell is missing or not an integer.
+inline std::vector<int> ParseDailyDegrees(const DataFrame& daily_df) {
+    std::vector<int> values(daily_df.size() * 22, 0);
+    for (size_t i = 0; i < daily_df.size(); ++i) {
+        for (size_t col = 0; col < 22 && col + 1 < daily_df[i].size(); ++col) {
+            parseInt(daily_df[i][col + 1], values[i * 22 + col]);
+        }
+    }
+    return values;
+}
+
+// (historical row, daily row) pair found in one historical file; the output
+// row is the raw daily row followed by the historical row
+using MatchPair = std::pair<uint32_t, uint32_t>;
+
+// One historical file with its matches, waiting to be written
+struct FileMatches {
+    DataFrame hist_df;
+    std::vector<MatchPair> pairs;
+};
+
+// Index engine: historical rows of one file grouped by (player, degree
+// columns) and keyed on the expected sum. A daily row computes one sum per
+// column set its player has and looks the sum up, instead of visiting every
+// historical row. Matches come back ordered as the scan produces them.
+inline std::vector<MatchPair> MatchFileWithIndex(const DataFrame& raw_hist_df, const DataFrame& daily_df, const std::vector<int>& daily_degrees) {
+    static const std::vector<std::string> daily_cols = { "AP", "AQ", "AR", "AS", "AT", "AU", "AV", "AW", "AX", "AY", "AZ", "BA", "BB", "BC", "BD", "BE", "BF", "BG", "BH", "BI", "BJ", "BK" };
+
+    struct ColumnGroup {
+        std::vector<uint8_t> cols;                        // may repeat a column, which then counts twice
+        std::vector<std::pair<int, uint32_t>> by_count;  // (degree count, historical row), sorted
+    };
+    std::vector<ColumnGroup> groups;
+    std::unordered_map<std::string, uint32_t> group_ids;               // player + '\0' + column bytes
+    std::unordered_map<std::string, std::vector<uint32_t>> player_groups;
+
+    for (size_t idx = 0; idx < raw_hist_df.size(); ++idx) {
+        const Row& hist_row = raw_hist_df[idx];
+        if (hist_row.size() < 5) continue;
+        int hist_degrees_count = 0;
+        if (!parseInt(hist_row[2], hist_degrees_count)) continue;
+
+        std::vector<uint8_t> cols;
+        for (size_t i = 0; i + 1 < hist_row[1].size(); i += 2) {
+            auto it = std::find(daily_cols.begin(), daily_cols.end(), hist_row[1].substr(i, 2));
+            if (it != daily_cols.end()) cols.push_back(static_cast<uint8_t>(std::distance(daily_cols.begin(), it)));
+        }
+        std::sort(cols.begin(), cols.end());
+
+        std::string key = hist_row[0];
+        key.push_back('\0');
+        key.append(cols.begin(), cols.end());
+        auto [it, inserted] = group_ids.emplace(key, static_cast<uint32_t>(groups.size()));
+        if (inserted) {
+            groups.push_back({ cols, {} });
+            player_groups[hist_row[0]].push_back(it->second);
+        }
+        groups[it->second].by_count.emplace_back(hist_degrees_count, static_cast<uint32_t>(idx));
+    }
+    for (auto& group : groups) std::sort(group.by_count.begin(), group.by_count.end());
+
+    std::vector<MatchPair> pairs;
+    for (size_t i = 0; i < daily_df.size(); ++i) {
+        if (daily_df[i].empty()) continue;
+        auto found = player_groups.find(daily_df[i][0]);
+        if (found == player_groups.end()) continue;
+        const int* degrees = daily_degrees.data() + i * 22;
+        for (uint32_t group_id : found->second) {
+            const ColumnGroup& group = groups[group_id];
+            int daily_degree_count = 0;
+            for (uint8_t col : group.cols) daily_degree_count += degrees[col];
+            auto range = std::equal_range(group.by_count.begin(), group.by_count.end(), std::make_pair(daily_degree_count, 0u),
+                [](const std::pair<int, uint32_t>& a, const std::pair<int, uint32_t>& b) { return a.first < b.first; });
+            for (auto it = range.first; it != range.second; ++it) pairs.emplace_back(it->second, static_cast<uint32_t>(i));
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+// Scan engine: every historical row checks every daily row of its player.
+inline std::vector<MatchPair> MatchFileWithScan(const DataFrame& raw_hist_df, const DataFrame& daily_df) {
+    std::vector<MatchPair> pairs;
+    for (size_t idx = 0; idx < raw_hist_df.size(); ++idx) {
+        const Row& hist_row = raw_hist_df[idx];
+        if (hist_row.size() < 5) continue;
+        std::string player = hist_row[0];
+        std::string degrees_str = hist_row[1];
+        std::string degrees_count_str = hist_row[2];
+        std::string win_percent = hist_row[4];
+        // Parse degree columns
+        std::vector<std::string> degree_cols;
+        for (size_t i = 0; i + 1 < degrees_str.size(); i += 2) {
+            degree_cols.push_back(degrees_str.substr(i, 2));
+        }
+        int hist_degrees_count = 0;
+        if (!parseInt(degrees_count_str, hist_degrees_count)) continue;
+        // For each daily row, check match
+        for (size_t i = 0; i < daily_df.size(); ++i) {
+            const Row& daily_row = daily_df[i];
+            if (daily_row.empty()) continue;
+            if (daily_row[0] != player) continue;
+            int daily_degree_count = 0;
+            for (const auto& col : degree_cols) {
+                // Find column index in daily_cols
+                static const std::vector<std::string> daily_cols = { "AP", "AQ", "AR", "AS", "AT", "AU", "AV", "AW", "AX", "AY", "AZ", "BA", "BB", "BC", "BD", "BE", "BF", "BG", "BH", "BI", "BJ", "BK" };
+                auto it = std::find(daily_cols.begin(), daily_cols.end(), col);
+                if (it == daily_cols.end()) continue;
+                size_t col_idx = std::distance(daily_cols.begin(), it) + 1; // +1 for Player
+                if (col_idx < daily_row.size()) {
+                    daily_degree_count += parseIntOr(daily_row[col_idx], 0);
+                }
+            }
+            if (daily_degree_count != hist_degrees_count) continue;
+            // Matched
+            pairs.emplace_back(static_cast<uint32_t>(idx), static_cast<uint32_t>(i));
+        }
+    }
+    return pairs;
+}
+
+// Matches output next to the daily file: <daily>_Matches.<format>
+inline std::filesystem::path DefaultOutputPath(const std::filesystem::path& daily_file, const std::string& format) {
+    std::filesystem::path output_path = daily_file;
+    output_path.replace_extension();
+    output_path += "_Matches." + format;
+    return output_path;
+}
+
+// Main processing logic. Historical files are read and matched as separate
+// tasks on a pool of threads workers (0 for all cores). Each file's matches
+// are streamed to out_path (.csv or .xlsx) in directory order as soon as
+// the file is done; only a few files past the one being written are in
+// flight, so memory stays flat. Returns the number of matches; with none,
+// no file is written. Throws on errors.
+inline size_t ProcessMatching(const std::filesystem::path& daily_file, const std::filesystem::path& hist_folder,
+    const std::filesystem::path& out_path, bool use_index, size_t threads, Progress& progress) {
+    progress.setStatus("Reading daily file...");
+    DataFrame raw_daily_df = CSVManager::read(daily_file);
+    DataFrame daily_df = FilterDailyData(raw_daily_df);
+    std::vector<int> daily_degrees;
+    if (use_index) daily_degrees = ParseDailyDegrees(daily_df);
+
+    std::vector<std::filesystem::path> hist_files;
+    for (const auto& entry : std::filesystem::directory_iterator(hist_folder)) {
+        if (!entry.is_regular_file()) continue;
+        std::wstring ext = entry.path().extension().wstring();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::towlower);
+        if (ext != L".csv" && ext != L".xlsx") continue;
+        hist_files.push_back(entry.path());
+    }
+    std::vector<std::string> file_names;
+    for (const auto& path : hist_files) file_names.push_back(CSVManager::ws2s(path.filename().wstring()));
+    progress.setFiles(std::move(file_names));
+    progress.setTotal(hist_files.size());
+
+    ThreadPool pool(threads);
+    size_t max_in_flight = pool.size() * 2;
+    std::deque<std::future<FileMatches>> in_flight;
+    size_t next_file = 0;
+    auto submit_next = [&]() {
+        size_t index = next_file++;
+        const std::filesystem::path& path = hist_files[index];
+        in_flight.push_back(pool.submit([&, index, path]() {
+            progress.setCurrentFile(index);
+            progress.addBytes(std::filesystem::file_size(path));
+            FileMatches result;
+            result.hist_df = CSVManager::read(path);
+            result.pairs = use_index ? MatchFileWithIndex(result.hist_df, daily_df, daily_degrees)
+                : MatchFileWithScan(result.hist_df, daily_df);
+            progress.addRows(result.hist_df.size());
+            progress.addMatches(result.pairs.size());
+            return result;
+            }));
+    };
+    while (next_file < hist_files.size() && in_flight.size() < max_in_flight) submit_next();
+
+    MatchWriter match_writer(out_path);
+    for (size_t f = 0; f < hist_files.size(); ++f) {
+        FileMatches file_matches = pool.wait(in_flight.front());
+        in_flight.pop_front();
+        if (next_file < hist_files.size()) submit_next();
+        for (const auto& [hist_idx, daily_idx] : file_matches.pairs) {
+            match_writer.write(raw_daily_df[daily_idx], file_matches.hist_df[hist_idx]);
+        }
+        progress.addDone();
+    }
+    // Finish output
+    if (match_writer.count() > 0) match_writer.close();
+    return match_writer.count();
+}
@@ -0,0 +1,123 @@
+// Console front end of Zmatcher, for batch servers and cron.
+//
+// zmatcher --daily FILE --hist FOLDER [--output FILE] [--format csv|xlsx]
+//          [--threads N] [--index] [--no-cache] [--quiet]
+// zmatcher --watch FOLDER --hist FOLDER [--output FOLDER] [--poll-ms N] ...
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include "../common/cli_args.h"
+#include "../common/console_progress.h"
+#include "../common/progress.h"
+#include "data_processor.h"
+#include "drop_folder.h"
+
+namespace {
+
+const char* kUsage =
+    "Usage: zmatcher --daily FILE --hist FOLDER [options]\n"
+    "       zmatcher --watch FOLDER --hist FOLDER [options]\n"
+    "\n"
+    "Matches the daily file against every .csv/.xlsx file in FOLDER.\n"
+    "\n"
+    "With --watch it keeps running with the historical folder loaded and\n"
+    "matches every daily file dropped into the watched folder. Matches go to\n"
+    "the output folder; served daily files move to processed/ or failed/.\n"
+    "Historical files are re-read only when they change. Stop with Ctrl+C.\n"
+    "\n"
+    "Options:\n"
+    "  --output FILE      output file (default <daily>_Matches.<format>);\n"
+    "                     with --watch the output folder (default <watch>/matches)\n"
+    "  --poll-ms N        with --watch, milliseconds between polls (default 1000)\n"
+    "  --format csv|xlsx  output format when --output is not given (default csv)\n"
+    "  --threads N        worker threads, 0 for all cores (default 0)\n"
+    "  --index            use the index engine (reverse join)\n"
+    "  --no-cache         parse the historical folder instead of using <folder>.zmidx\n"
+    "  --quiet            no progress on stderr\n";
+
+std::string formatProgress(const Progress::Snapshot& shot) {
+    if (shot.current.empty()) return shot.status;
+    return "Processing file: " + shot.current + " (" + std::to_string(shot.done) + "/" + std::to_string(shot.total) + "), " +
+        std::to_string(shot.rows) + " rows, " + std::to_string(shot.matches) + " matches";
+}
+
+std::atomic<bool> g_stop{ false };
+
+extern "C" void onStopSignal(int) { g_stop.store(true); }
+
+// Resident mode: serves the drop folder until SIGINT/SIGTERM
+int runWatch(const CliArgs& args) {
+    if (args.has("--daily")) throw UsageError("--daily and --watch cannot be combined");
+    if (args.flag("--no-cache")) throw UsageError("--watch always keeps the historical cache");
+    int poll_ms = args.getInt("--poll-ms", 1000);
+    if (poll_ms <= 0) throw UsageError("--poll-ms must be positive");
+
+    DropFolderService::Options options;
+    options.hist_folder = std::filesystem::u8path(args.require("--hist"));
+    options.watch_dir = std::filesystem::u8path(args.require("--watch"));
+    if (args.has("--output")) options.output_dir = std::filesystem::u8path(args.get("--output"));
+    options.format = args.format("csv");
+    options.use_index = args.flag("--index");
+    options.poll_interval = std::chrono::milliseconds(poll_ms);
+    if (!std::filesystem::is_directory(options.hist_folder)) throw std::runtime_error("Historical folder not found.");
+    if (!std::filesystem::is_directory(options.watch_dir)) throw std::runtime_error("Watch folder not found.");
+
+    DataProcessor processor(args.threads());
+    bool quiet = args.flag("--quiet");
+    DropFolderService service(processor, options, [quiet](const std::string& line) {
+        if (!quiet) std::cout << line << std::endl;
+        });
+    service.warmUp();
+
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+    if (!quiet) std::cout << "Watching " << options.watch_dir.u8string() << std::endl;
+    service.run(g_stop);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        CliArgs args(argc, argv, { "--daily", "--hist", "--output", "--format", "--threads", "--watch", "--poll-ms" }, { "--index", "--no-cache", "--quiet" });
+        if (args.flag("--help")) {
+            std::cout << kUsage;
+            return 0;
+        }
+        if (args.has("--watch")) return runWatch(args);
+        std::string daily_file = args.require("--daily");
+        std::string hist_folder = args.require("--hist");
+        std::filesystem::path output_path = args.has("--output")
+            ? std::filesystem::u8path(args.get("--output"))
+            : DataProcessor::defaultOutputPath(std::filesystem::u8path(daily_file), args.format("csv"));
+
+        DataProcessor processor(args.threads());
+        Progress progress;
+        progress.start();
+        ConsoleProgress reporter(progress, formatProgress, !args.flag("--quiet"));
+        size_t matches = processor.processFiles(std::filesystem::u8path(daily_file), std::filesystem::u8path(hist_folder),
+            output_path, args.flag("--index"), !args.flag("--no-cache"), progress);
+        progress.finish();
+        reporter.stop();
+
+        if (matches > 0) {
+            std::cout << "Processing finished. " << matches << " matches saved to: " << output_path.u8string() << std::endl;
+        }
+        else {
+            std::cout << "NO Matches found..." << std::endl;
+        }
+        return 0;
+    }
+    catch (const UsageError& e) {
+        std::cerr << e.what() << "\n\n" << kUsage;
+        return 2;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error occurred: " << e.what() << std::endl;
+        return 1;
+    }
+}
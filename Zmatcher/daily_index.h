@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "../common/data_frame.h"
+#include "../common/string_pool.h"
+
+// Groups daily rows by player (column 0) once per run, so each historical
+// row only visits the daily rows of its own player instead of the whole table.
+class DailyIndex {
+public:
+    struct Range {
+        const uint32_t* first;
+        const uint32_t* last;
+        const uint32_t* begin() const { return first; }
+        const uint32_t* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+    };
+
+    DailyIndex() = default;
+    explicit DailyIndex(const DataFrame& daily_df) { build(daily_df); }
+
+    void build(const DataFrame& daily_df) {
+        players = StringPool();
+        std::vector<uint32_t> row_player(daily_df.size(), StringPool::npos);
+        for (size_t i = 0; i < daily_df.size(); ++i) {
+            if (!daily_df[i].empty()) {
+                row_player[i] = players.intern(daily_df[i][0]);
+            }
+        }
+
+        // Counting sort into one flat array: rows of player p live in
+        // [offsets[p], offsets[p + 1]) and keep their original order.
+        offsets.assign(players.size() + 1, 0);
+        for (uint32_t p : row_player) {
+            if (p != StringPool::npos) offsets[p + 1]++;
+        }
+        for (size_t p = 1; p < offsets.size(); ++p) {
+            offsets[p] += offsets[p - 1];
+        }
+        rows.resize(offsets.back());
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < row_player.size(); ++i) {
+            if (row_player[i] != StringPool::npos) {
+                rows[cursor[row_player[i]]++] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+
+    // Interned code of a player, or StringPool::npos if no daily row has it
+    uint32_t playerId(std::string_view player) const { return players.find(player); }
+
+    Range rowsFor(uint32_t player_id) const {
+        if (player_id == StringPool::npos) return { nullptr, nullptr };
+        return { rows.data() + offsets[player_id], rows.data() + offsets[player_id + 1] };
+    }
+
+    Range rowsFor(std::string_view player) const { return rowsFor(playerId(player)); }
+
+    const StringPool& playerPool() const { return players; }
+
+private:
+    StringPool players;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> rows;
+};
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../common/csv_manager.h"
+#include "../common/data_frame.h"
+#include "../common/match_writer.h"
+#include "../common/progress.h"
+#include "../common/thread_pool.h"
+#include "daily_index.h"
+#include "hist_cache.h"
+#include "hist_prefetcher.h"
+#include "match_rules.h"
+#include "rule_index.h"
+
+// Matching core shared by the Win32 GUI (main.cpp) and the console tool
+// (cli.cpp). Reports through a Progress and throws on errors; it never
+// touches a window.
+//
+// The historical cache lives as long as the processor, so a processor that
+// is kept (the GUI's, or the resident service's) matches later daily files
+// against the folder already in memory.
+class DataProcessor {
+private:
+    ThreadPool pool;
+    size_t prefetch_depth = HistPrefetcher::kDefaultDepth;
+    HistCache hist_cache;
+
+public:
+    // threads == 0 uses one worker per hardware thread
+    explicit DataProcessor(size_t threads = 0) : pool(threads) {}
+
+    // Historical files read ahead of the one being matched (uncached runs)
+    void setPrefetchDepth(size_t depth) { prefetch_depth = depth; }
+
+    // (historical row, daily row) pair found in one historical file
+    using MatchPair = std::pair<uint32_t, uint32_t>;
+
+    // Compiles a parsed historical file; rows whose player is not in the
+    // daily file produce no rule.
+    void compileRules(const DataFrame& raw_hist_df,
+        const DailyIndex& daily_index,
+        const DailyTable& daily_table,
+        RuleSet& rule_set) {
+        rule_set.rules.reserve(raw_hist_df.size());
+        for (size_t idx = 0; idx < raw_hist_df.size(); ++idx) {
+            rule_set.compile(raw_hist_df[idx], static_cast<uint32_t>(idx), daily_index, daily_table);
+        }
+    }
+
+    // Scan engine: rules [first, last) each visit the daily rows of their own
+    // player. Pairs come out ordered by historical row, then daily row.
+    std::vector<MatchPair> scanRules(const RuleSet& rule_set, size_t first, size_t last,
+        const DailyIndex& daily_index,
+        const DailyTable& daily_table) {
+        std::vector<MatchPair> pairs;
+
+        for (size_t r = first; r < last; ++r) {
+            const CompiledRule& rule = rule_set.rules[r];
+
+            // Only visit the daily rows of this player
+            for (uint32_t i : daily_index.rowsFor(rule.player)) {
+                if (!rule_set.matches(rule, daily_table.row(i))) continue;
+                pairs.emplace_back(rule.hist_row, i);
+            }
+        }
+        return pairs;
+    }
+
+    // Reverse-join engine: daily rows [first, last) probe the file's rule
+    // index. Pairs come out in daily row order.
+    std::vector<MatchPair> probeRules(const RuleSet& rule_set, const RuleIndex& rule_index, size_t first, size_t last,
+        const DataFrame& daily_df,
+        const DailyIndex& daily_index,
+        const DailyTable& daily_table) {
+        std::vector<MatchPair> pairs;
+        for (size_t i = first; i < last; ++i) {
+            uint32_t player = daily_index.playerId(daily_df[i][0]);
+            if (player == StringPool::npos) continue;
+            rule_index.probe(player, daily_table.row(i), [&](uint32_t r) {
+                pairs.emplace_back(rule_set.rules[r].hist_row, static_cast<uint32_t>(i));
+            });
+        }
+        return pairs;
+    }
+
+    // Runs one file's rules through the selected engine on the thread pool.
+    // Both engines return the same pairs in the same order.
+    std::vector<MatchPair> matchRules(const RuleSet& rule_set, bool use_index,
+        const DataFrame& daily_df,
+        const DailyIndex& daily_index,
+        const DailyTable& daily_table) {
+        RuleIndex rule_index;
+        if (use_index) rule_index.build(rule_set);
+
+        // The scan splits the rules, the index splits the daily rows
+        size_t total = use_index ? daily_df.size() : rule_set.rules.size();
+        size_t grain = pool.grainFor(total);
+        std::vector<std::vector<MatchPair>> chunk_pairs((total + grain - 1) / grain);
+
+        // Process chunks in parallel
+        pool.parallelFor(0, total, grain, [&](size_t begin, size_t end) {
+            chunk_pairs[begin / grain] = use_index
+                ? probeRules(rule_set, rule_index, begin, end, daily_df, daily_index, daily_table)
+                : scanRules(rule_set, begin, end, daily_index, daily_table);
+            });
+
+        // Collect results in chunk order
+        std::vector<MatchPair> pairs;
+        for (const auto& chunk : chunk_pairs) {
+            pairs.insert(pairs.end(), chunk.begin(), chunk.end());
+        }
+        if (use_index) std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    }
+
+    // Streams one file's matches, the raw daily row followed by the
+    // historical row, to the output. Empty rows are left out.
+    template <typename GetHistRow>
+    void writeMatches(const std::vector<MatchPair>& pairs,
+        const DataFrame& raw_daily_df,
+        GetHistRow&& hist_row,
+        MatchWriter& match_writer) {
+        for (const auto& [hist_idx, daily_idx] : pairs) {
+            const Row& daily = raw_daily_df[daily_idx];
+            const auto& hist = hist_row(hist_idx);
+            if (daily.empty() && hist.empty()) continue;
+            match_writer.write(daily, hist);
+        }
+    }
+
+    DataFrame filterDailyData(const DataFrame& raw_daily_df) {
+        DataFrame filtered_data;
+
+        for (const Row& row : raw_daily_df) {
+            Row filtered_row;
+
+            // Extract column 0 (Player)
+            if (!row.empty()) {
+                filtered_row.push_back(row[0]);
+            }
+
+            // Extract columns 41-62 (indices 41-62)
+            for (int i = 41; i <= 62 && i < static_cast<int>(row.size()); ++i) {
+                filtered_row.push_back(row[i]);
+            }
+
+            if (!filtered_row.empty()) {
+                filtered_data.push_back(filtered_row);
+            }
+        }
+
+        return filtered_data;
+    }
+
+    // Matches output next to the daily file: <daily>_Matches.<format>
+    static std::filesystem::path defaultOutputPath(const std::filesystem::path& daily_file, const std::string& format = "csv") {
+        std::filesystem::path output_path = daily_file;
+        output_path.replace_extension();
+        output_path += "_Matches." + format;
+        return output_path;
+    }
+
+    // The .csv/.xlsx files of the historical folder
+    static std::vector<std::filesystem::path> listHistoricalFiles(const std::filesystem::path& historical_folder) {
+        std::vector<std::filesystem::path> hist_files;
+        for (const auto& entry : std::filesystem::directory_iterator(historical_folder)) {
+            if (entry.is_regular_file()) {
+                std::string ext = entry.path().extension().string();
+                if (ext == ".csv" || ext == ".xlsx") {
+                    hist_files.push_back(entry.path());
+                }
+            }
+        }
+        return hist_files;
+    }
+
+    // Brings the historical cache up to date with hist_files; only new or
+    // changed files are parsed. Returns the number of files parsed.
+    size_t refreshHistorical(const std::filesystem::path& historical_folder,
+        const std::vector<std::filesystem::path>& hist_files, Progress& progress) {
+        return hist_cache.open(historical_folder, hist_files, [&progress](const std::filesystem::path& path) {
+            progress.setStatus("Parsing file: " + path.filename().u8string());
+            progress.addBytes(std::filesystem::file_size(path));
+            return CSVManager::read(path);
+            });
+    }
+
+    // Matches the daily file against every .csv/.xlsx file of the
+    // historical folder and streams the matches to output_path (.csv or
+    // .xlsx). Returns the number of matches; with none, no file is
+    // written. Throws on errors.
+    size_t processFiles(const std::filesystem::path& daily_file, const std::filesystem::path& historical_folder,
+        const std::filesystem::path& output_path, bool use_index, bool use_cache, Progress& progress) {
+        // Check if files exist
+        if (!std::filesystem::exists(daily_file) || !std::filesystem::exists(historical_folder)) {
+            throw std::runtime_error("One or both files not found.");
+        }
+
+        // Read daily file (now supports .csv and .xlsx)
+        progress.setStatus("Reading daily file...");
+        DataFrame raw_daily_df = CSVManager::read(daily_file);
+        DataFrame daily_df = filterDailyData(raw_daily_df);
+        DailyIndex daily_index(daily_df);
+        DailyTable daily_table;
+        daily_table.build(daily_df);
+
+        // Matches go to disk file by file as they are found
+        MatchWriter match_writer(output_path);
+
+        // Collect historical files
+        std::vector<std::filesystem::path> hist_files = listHistoricalFiles(historical_folder);
+        int total_files = static_cast<int>(hist_files.size());
+        std::vector<std::string> file_names;
+        for (const auto& path : hist_files) file_names.push_back(path.filename().u8string());
+        progress.setFiles(std::move(file_names));
+        progress.setTotal(total_files);
+
+        // Bring the cache up to date; only new or changed files are parsed
+        if (use_cache) {
+            progress.setStatus("Loading historical cache...");
+            size_t parsed_files = refreshHistorical(historical_folder, hist_files, progress);
+            std::string cache_msg = "Historical cache ready, parsed " + std::to_string(parsed_files) + " of " + std::to_string(total_files) + " files";
+            progress.setStatus(cache_msg);
+        }
+
+        // Without the cache, upcoming files are parsed while the current one is matched
+        std::unique_ptr<HistPrefetcher> prefetcher;
+        if (!use_cache) {
+            prefetcher = std::make_unique<HistPrefetcher>(pool, hist_files, [&progress](const std::filesystem::path& path) {
+                progress.addBytes(std::filesystem::file_size(path));
+                return CSVManager::read(path);
+                }, prefetch_depth);
+        }
+
+        // Process each file in historical folder
+        for (size_t f = 0; f < hist_files.size(); ++f) {
+            progress.setCurrentFile(f);
+
+            RuleSet rule_set;
+            if (use_cache) {
+                const HistCache::FileView& view = hist_cache.file(f);
+                view.remapRules(daily_index, daily_table, rule_set);
+                auto pairs = matchRules(rule_set, use_index, daily_df, daily_index, daily_table);
+                progress.addRows(view.rowCount());
+                progress.addMatches(pairs.size());
+                writeMatches(pairs, raw_daily_df, [&](uint32_t idx) { return view.row(idx); }, match_writer);
+            }
+            else {
+                DataFrame raw_hist_df = prefetcher->take();
+                compileRules(raw_hist_df, daily_index, daily_table, rule_set);
+                auto pairs = matchRules(rule_set, use_index, daily_df, daily_index, daily_table);
+                progress.addRows(raw_hist_df.size());
+                progress.addMatches(pairs.size());
+                writeMatches(pairs, raw_daily_df, [&](uint32_t idx) -> const Row& { return raw_hist_df[idx]; }, match_writer);
+            }
+
+            progress.addDone();
+        }
+
+        // Save results
+        if (match_writer.count() > 0) match_writer.close();
+        return match_writer.count();
+    }
+};
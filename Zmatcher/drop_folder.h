@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../common/progress.h"
+#include "data_processor.h"
+
+// Resident matcher: watches a drop folder for daily files and matches each
+// one against a historical folder that stays loaded in one DataProcessor.
+// Only historical files whose size or mtime changed are parsed again, so a
+// request costs the daily file and the matching, not the folder load.
+//
+// A daily file is taken once its size and mtime held still for one poll,
+// so a copy still in progress is left alone. Its matches are written to
+// <output>/<daily>_Matches.<format> through a .partial file that is
+// renamed when complete; the daily file then moves to processed/ (or
+// failed/) under the drop folder. With no matches no output is written.
+class DropFolderService {
+public:
+    struct Options {
+        std::filesystem::path hist_folder;
+        std::filesystem::path watch_dir;
+        std::filesystem::path output_dir;   // empty for <watch_dir>/matches
+        std::string format = "csv";
+        bool use_index = false;
+        std::chrono::milliseconds poll_interval{ 1000 };
+    };
+
+    using Log = std::function<void(const std::string&)>;
+
+    DropFolderService(DataProcessor& processor, Options options, Log log)
+        : processor(processor), options(std::move(options)), log(std::move(log)) {
+        if (this->options.output_dir.empty()) this->options.output_dir = this->options.watch_dir / "matches";
+        std::filesystem::create_directories(this->options.output_dir);
+        std::filesystem::create_directories(this->options.watch_dir / "processed");
+        std::filesystem::create_directories(this->options.watch_dir / "failed");
+    }
+
+    // Loads the historical folder ahead of the first request. Returns the
+    // number of files parsed (the rest came from the cache).
+    size_t warmUp() {
+        Progress progress;
+        progress.start();
+        auto hist_files = DataProcessor::listHistoricalFiles(options.hist_folder);
+        size_t parsed = processor.refreshHistorical(options.hist_folder, hist_files, progress);
+        progress.finish();
+        log("Historical folder loaded: " + std::to_string(hist_files.size()) + " files, " +
+            std::to_string(parsed) + " parsed");
+        return parsed;
+    }
+
+    // Matches the daily files that are ready; returns how many were taken
+    size_t pollOnce() {
+        std::map<std::filesystem::path, FileState> current;
+        std::map<std::filesystem::path, FileState> still_stuck;
+        std::vector<std::filesystem::path> ready;
+        for (const auto& entry : std::filesystem::directory_iterator(options.watch_dir)) {
+            if (!entry.is_regular_file()) continue;
+            std::string name = entry.path().filename().u8string();
+            std::string ext = entry.path().extension().string();
+            if (name[0] == '.' || name.compare(0, 2, "~$") == 0 || (ext != ".csv" && ext != ".xlsx")) continue;
+
+            FileState state;
+            if (!readState(entry.path(), state)) continue;
+
+            // A file that could not be moved away is skipped until it is
+            // replaced by another one
+            auto unmoved = stuck.find(entry.path());
+            if (unmoved != stuck.end() && unmoved->second == state) {
+                still_stuck.insert(*unmoved);
+                continue;
+            }
+
+            auto last = seen.find(entry.path());
+            if (last != seen.end() && last->second == state) {
+                ready.push_back(entry.path());
+            }
+            else {
+                current[entry.path()] = state;
+            }
+        }
+        seen = std::move(current);
+        stuck = std::move(still_stuck);
+
+        for (const auto& daily_file : ready) serve(daily_file);
+        return ready.size();
+    }
+
+    // Polls until stop is set
+    void run(const std::atomic<bool>& stop) {
+        while (!stop.load()) {
+            pollOnce();
+            // Sleep in short steps so a stop request is seen quickly
+            auto wake = std::chrono::steady_clock::now() + options.poll_interval;
+            while (!stop.load() && std::chrono::steady_clock::now() < wake) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+        }
+    }
+
+private:
+    struct FileState {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+
+        bool operator==(const FileState& other) const { return size == other.size && mtime == other.mtime; }
+    };
+
+    static bool readState(const std::filesystem::path& path, FileState& state) {
+        std::error_code ec;
+        state.size = static_cast<uint64_t>(std::filesystem::file_size(path, ec));
+        if (ec) return false;
+        state.mtime = static_cast<int64_t>(std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+        return !ec;
+    }
+
+    void serve(const std::filesystem::path& daily_file) {
+        std::string name = daily_file.filename().u8string();
+        std::filesystem::path output_path = options.output_dir / DataProcessor::defaultOutputPath(daily_file, options.format).filename();
+
+        auto started = std::chrono::steady_clock::now();
+        try {
+            Progress progress;
+            progress.start();
+            size_t matches = processor.processFiles(daily_file, options.hist_folder, output_path, options.use_index, true, progress);
+            progress.finish();
+            moveTo(daily_file, "processed");
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+            log(name + ": " + std::to_string(matches) + " matches in " + std::to_string(ms) + " ms" +
+                (matches > 0 ? " -> " + output_path.u8string() : ""));
+        }
+        catch (const std::exception& e) {
+            moveTo(daily_file, "failed");
+            log(name + ": failed: " + e.what());
+        }
+    }
+
+    // Moves a served daily file out of the drop folder, replacing an older copy
+    void moveTo(const std::filesystem::path& daily_file, const char* subfolder) {
+        std::error_code ec;
+        std::filesystem::path target = options.watch_dir / subfolder / daily_file.filename();
+        std::filesystem::remove(target, ec);
+        std::filesystem::rename(daily_file, target, ec);
+        if (ec) {
+            // Served once is enough; it stays where it is until it goes away
+            // or changes
+            FileState state;
+            if (readState(daily_file, state)) stuck[daily_file] = state;
+            log(daily_file.filename().u8string() + ": cannot move to " + subfolder + ": " + ec.message());
+        }
+    }
+
+    DataProcessor& processor;
+    Options options;
+    Log log;
+    std::map<std::filesystem::path, FileState> seen;  // files waiting to hold still
+    std::map<std::filesystem::path, FileState> stuck; // served but could not be moved
+};
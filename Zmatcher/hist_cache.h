@@ -0,0 +1,445 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+#include "../common/data_frame.h"
+#include "../common/mapped_file.h"
+#include "../common/string_pool.h"
+#include "daily_index.h"
+#include "match_rules.h"
+
+// Binary cache of a historical folder, stored next to it as <folder>.zmidx.
+// Every source file is kept as one block: the file's distinct strings, its
+// rows as codes into them, and its rules compiled against those codes.
+// Files whose size and mtime are unchanged load straight from the mapping;
+// only new or changed files are parsed again.
+//
+// A HistCache that stays alive keeps its folder loaded: opening the same
+// folder again only stats the files and reuses the blocks already in
+// memory, which is what the resident matcher relies on.
+//
+// Layout (native endian, blocks 8-byte aligned):
+//   header   magic, version, file count, struct sizes
+//   entries  per file: size, mtime, block offset, block length, name
+//   blocks   strings | rows | rules, degree terms, exact terms
+class HistCache {
+public:
+    // One source file's block inside the cache
+    class FileView {
+    public:
+        size_t rowCount() const { return row_count; }
+
+        Row row(size_t i) const {
+            Row out;
+            if (i >= row_count) return out;
+            uint32_t first = row_offsets[i], last = row_offsets[i + 1];
+            out.reserve(last - first);
+            for (uint32_t c = first; c < last; ++c) out.emplace_back(str(cells[c]));
+            return out;
+        }
+
+        // Appends this file's rules to out with player and value codes
+        // translated to today's daily file. Rules whose player is not in the
+        // daily file are dropped, the same as RuleSet::compile does.
+        void remapRules(const DailyIndex& daily_index, const DailyTable& daily_table, RuleSet& out) const {
+            constexpr uint32_t kUnmapped = StringPool::npos - 1;
+            std::vector<uint32_t> player_map(string_count, kUnmapped);
+            std::vector<uint32_t> value_map(string_count, kUnmapped);
+
+            for (uint32_t r = 0; r < rule_count; ++r) {
+                const CompiledRule& local = rules[r];
+                if (local.player >= string_count || local.first_degree + local.degree_count > degree_count ||
+                    local.first_exact + local.exact_count > exact_count) {
+                    continue;
+                }
+                uint32_t& player = player_map[local.player];
+                if (player == kUnmapped) player = daily_index.playerId(str(local.player));
+                if (player == StringPool::npos) continue;
+
+                CompiledRule rule = local;
+                rule.player = player;
+                rule.first_degree = static_cast<uint32_t>(out.degree_terms.size());
+                rule.first_exact = static_cast<uint32_t>(out.exact_terms.size());
+                out.degree_terms.insert(out.degree_terms.end(),
+                    degree_terms + local.first_degree, degree_terms + local.first_degree + local.degree_count);
+                for (uint32_t t = local.first_exact; t < local.first_exact + local.exact_count; ++t) {
+                    ExactTerm term = exact_terms[t];
+                    if (term.code < string_count) {
+                        uint32_t& code = value_map[term.code];
+                        if (code == kUnmapped) code = daily_table.valuePool().find(str(term.code));
+                        term.code = code;
+                    }
+                    else {
+                        term.code = StringPool::npos;
+                    }
+                    out.exact_terms.push_back(term);
+                }
+                out.rules.push_back(rule);
+            }
+        }
+
+    private:
+        friend class HistCache;
+
+        std::string_view str(uint32_t code) const {
+            if (code >= string_count) return {};
+            return std::string_view(string_bytes + string_offsets[code], string_offsets[code + 1] - string_offsets[code]);
+        }
+
+        uint32_t string_count = 0;
+        const uint32_t* string_offsets = nullptr;
+        const char* string_bytes = nullptr;
+        uint32_t row_count = 0;
+        const uint32_t* row_offsets = nullptr;
+        const uint32_t* cells = nullptr;
+        uint32_t rule_count = 0;
+        uint32_t degree_count = 0;
+        uint32_t exact_count = 0;
+        const CompiledRule* rules = nullptr;
+        const DegreeTerm* degree_terms = nullptr;
+        const ExactTerm* exact_terms = nullptr;
+    };
+
+    static std::filesystem::path cachePathFor(const std::filesystem::path& folder) {
+        std::filesystem::path dir = folder;
+        if (!dir.has_filename()) dir = dir.parent_path(); // trailing separator
+        return dir.parent_path() / (dir.filename().u8string() + ".zmidx");
+    }
+
+    // Brings the cache up to date with files (all inside folder) and maps it.
+    // load(path) must return the parsed rows of one source file; it is only
+    // called for files that are new or changed since the cache was written.
+    // Returns the number of files that were parsed.
+    template <typename Load>
+    size_t open(const std::filesystem::path& folder, const std::vector<std::filesystem::path>& files, Load&& load) {
+        views.clear();
+        std::filesystem::path cache_path = cachePathFor(folder);
+
+        // The folder loaded last time is reused from memory, not re-read
+        MappedFile old_map;
+        std::vector<std::vector<char>> old_owned;
+        std::unordered_map<std::string, Entry> old_entries;
+        if (cache_path == loaded_path && !loaded_path.empty()) {
+            old_map = std::move(map);
+            old_owned = std::move(owned);
+            old_entries = std::move(loaded);
+        }
+        else {
+            map.close();
+            if (old_map.open(cache_path) && !readEntries(old_map, old_entries)) old_entries.clear();
+        }
+        owned.clear();
+        loaded.clear();
+        loaded_path.clear();
+
+        std::vector<Entry> entries;
+        size_t parsed = 0;
+        bool changed = old_entries.size() != files.size();
+        for (const auto& file : files) {
+            Entry entry;
+            entry.name = file.filename().u8string();
+            entry.size = static_cast<uint64_t>(std::filesystem::file_size(file));
+            entry.mtime = static_cast<int64_t>(std::filesystem::last_write_time(file).time_since_epoch().count());
+
+            auto cached = old_entries.find(entry.name);
+            FileView view;
+            if (cached != old_entries.end() && cached->second.size == entry.size && cached->second.mtime == entry.mtime &&
+                parseBlock(cached->second.data, cached->second.length, view)) {
+                entry.data = cached->second.data;
+                entry.length = cached->second.length;
+            }
+            else {
+                owned.push_back(encodeBlock(load(file)));
+                entry.data = owned.back().data();
+                entry.length = owned.back().size();
+                parsed++;
+                changed = true;
+            }
+            entries.push_back(std::move(entry));
+        }
+
+        if (changed) {
+            std::filesystem::path tmp_path = cache_path;
+            tmp_path += ".tmp";
+            if (writeCache(tmp_path, entries)) {
+                // Windows cannot replace a file that is still mapped
+                old_map.close();
+                std::error_code ec;
+                std::filesystem::rename(tmp_path, cache_path, ec);
+                std::unordered_map<std::string, Entry> written;
+                if (!map.open(ec ? tmp_path : cache_path) || !readEntries(map, written)) {
+                    throw std::runtime_error("Cannot map historical cache: " + cache_path.u8string());
+                }
+                owned.clear();
+                for (auto& entry : entries) {
+                    entry.data = written.at(entry.name).data;
+                    entry.length = written.at(entry.name).length;
+                }
+            }
+            else {
+                // Folder not writable: serve from memory, keeping the blocks reused from it
+                map = std::move(old_map);
+                for (auto& block : old_owned) owned.push_back(std::move(block));
+            }
+        }
+        else {
+            map = std::move(old_map);
+            owned = std::move(old_owned);
+        }
+
+        for (const auto& entry : entries) {
+            FileView view;
+            if (!parseBlock(entry.data, entry.length, view)) {
+                throw std::runtime_error("Corrupt historical cache block: " + entry.name);
+            }
+            views.push_back(view);
+            loaded[entry.name] = entry;
+        }
+        loaded_path = cache_path;
+        return parsed;
+    }
+
+    // Views in the order of the files passed to open
+    const FileView& file(size_t i) const { return views[i]; }
+    size_t fileCount() const { return views.size(); }
+
+private:
+    static constexpr char kMagic[8] = { 'Z', 'M', 'I', 'D', 'X', 0, 0, 0 };
+    static constexpr uint32_t kVersion = 1;
+
+    struct Entry {
+        std::string name;
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        const char* data = nullptr;
+        size_t length = 0;
+    };
+
+    static size_t align(size_t n, size_t to) { return (n + to - 1) / to * to; }
+
+    template <typename T>
+    static void put(std::vector<char>& out, const T& value) {
+        const char* p = reinterpret_cast<const char*>(&value);
+        out.insert(out.end(), p, p + sizeof(T));
+    }
+
+    template <typename T>
+    static void putArray(std::vector<char>& out, const std::vector<T>& values) {
+        const char* p = reinterpret_cast<const char*>(values.data());
+        out.insert(out.end(), p, p + values.size() * sizeof(T));
+    }
+
+    static void pad(std::vector<char>& out, size_t to) { out.resize(align(out.size(), to), 0); }
+
+    static std::vector<char> encodeBlock(const DataFrame& df) {
+        StringPool pool;
+        std::vector<uint32_t> row_offsets{ 0 };
+        std::vector<uint32_t> cells;
+        for (const Row& row : df) {
+            for (const std::string& cell : row) cells.push_back(pool.intern(cell));
+            row_offsets.push_back(static_cast<uint32_t>(cells.size()));
+        }
+
+        RuleSet rule_set;
+        auto local_code = [&](const std::string& value) { return pool.intern(value); };
+        for (size_t idx = 0; idx < df.size(); ++idx) {
+            rule_set.compileWith(df[idx], static_cast<uint32_t>(idx), local_code, local_code);
+        }
+
+        std::vector<uint32_t> string_offsets{ 0 };
+        std::string string_bytes;
+        for (uint32_t code = 0; code < pool.size(); ++code) {
+            string_bytes += pool.str(code);
+            string_offsets.push_back(static_cast<uint32_t>(string_bytes.size()));
+        }
+
+        std::vector<char> out;
+        put(out, static_cast<uint32_t>(pool.size()));
+        put(out, static_cast<uint32_t>(string_bytes.size()));
+        putArray(out, string_offsets);
+        out.insert(out.end(), string_bytes.begin(), string_bytes.end());
+        pad(out, 4);
+
+        put(out, static_cast<uint32_t>(df.size()));
+        put(out, static_cast<uint32_t>(cells.size()));
+        putArray(out, row_offsets);
+        putArray(out, cells);
+
+        put(out, static_cast<uint32_t>(rule_set.rules.size()));
+        put(out, static_cast<uint32_t>(rule_set.degree_terms.size()));
+        put(out, static_cast<uint32_t>(rule_set.exact_terms.size()));
+        put(out, uint32_t(0));
+        putArray(out, rule_set.rules);
+        // Terms are copied field by field so struct padding is written as zeros
+        for (const DegreeTerm& term : rule_set.degree_terms) {
+            DegreeTerm clean;
+            std::memset(&clean, 0, sizeof(clean));
+            clean.col = term.col;
+            clean.low = term.low;
+            clean.high = term.high;
+            put(out, clean);
+        }
+        for (const ExactTerm& term : rule_set.exact_terms) {
+            ExactTerm clean;
+            std::memset(&clean, 0, sizeof(clean));
+            clean.col = term.col;
+            clean.code = term.code;
+            put(out, clean);
+        }
+        return out;
+    }
+
+    // Reads fixed-size fields and arrays out of a byte range, failing on overrun
+    class Cursor {
+    public:
+        Cursor(const char* data, size_t length) : data(data), length(length) {}
+
+        template <typename T>
+        bool get(T& value) {
+            if (length - pos < sizeof(T)) return false;
+            std::memcpy(&value, data + pos, sizeof(T));
+            pos += sizeof(T);
+            return true;
+        }
+
+        template <typename T>
+        bool array(const T*& first, size_t count) {
+            if (count > (length - pos) / sizeof(T)) return false;
+            first = reinterpret_cast<const T*>(data + pos);
+            pos += count * sizeof(T);
+            return true;
+        }
+
+        bool skip(size_t n) {
+            if (length - pos < n) return false;
+            pos += n;
+            return true;
+        }
+
+        bool alignTo(size_t to) { return skip(align(pos, to) - pos); }
+        size_t offset() const { return pos; }
+
+    private:
+        const char* data;
+        size_t length;
+        size_t pos = 0;
+    };
+
+    static bool parseBlock(const char* data, size_t length, FileView& view) {
+        Cursor in(data, length);
+        uint32_t string_bytes_size = 0, cell_count = 0, reserved = 0;
+        if (!in.get(view.string_count) || !in.get(string_bytes_size) ||
+            !in.array(view.string_offsets, size_t(view.string_count) + 1) ||
+            !in.array(view.string_bytes, string_bytes_size) || !in.alignTo(4)) {
+            return false;
+        }
+        if (!in.get(view.row_count) || !in.get(cell_count) ||
+            !in.array(view.row_offsets, size_t(view.row_count) + 1) || !in.array(view.cells, cell_count)) {
+            return false;
+        }
+        if (!in.get(view.rule_count) || !in.get(view.degree_count) || !in.get(view.exact_count) || !in.get(reserved) ||
+            !in.array(view.rules, view.rule_count) || !in.array(view.degree_terms, view.degree_count) ||
+            !in.array(view.exact_terms, view.exact_count)) {
+            return false;
+        }
+
+        // Offsets must stay inside their arrays; row() and str() rely on it
+        for (uint32_t i = 0; i < view.string_count; ++i) {
+            if (view.string_offsets[i] > view.string_offsets[i + 1]) return false;
+        }
+        if (view.string_offsets[view.string_count] > string_bytes_size) return false;
+        for (uint32_t i = 0; i < view.row_count; ++i) {
+            if (view.row_offsets[i] > view.row_offsets[i + 1]) return false;
+        }
+        return view.row_offsets[view.row_count] <= cell_count;
+    }
+
+    static bool readEntries(const MappedFile& file, std::unordered_map<std::string, Entry>& entries) {
+        entries.clear();
+        Cursor in(file.data(), file.size());
+        const char* magic = nullptr;
+        uint32_t version = 0, file_count = 0, rule_size = 0, degree_size = 0, exact_size = 0, reserved = 0;
+        if (!in.array(magic, sizeof(kMagic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) return false;
+        if (!in.get(version) || !in.get(file_count) || !in.get(rule_size) || !in.get(degree_size) ||
+            !in.get(exact_size) || !in.get(reserved)) {
+            return false;
+        }
+        if (version != kVersion || rule_size != sizeof(CompiledRule) || degree_size != sizeof(DegreeTerm) ||
+            exact_size != sizeof(ExactTerm)) {
+            return false;
+        }
+
+        for (uint32_t f = 0; f < file_count; ++f) {
+            Entry entry;
+            uint64_t offset = 0, length = 0;
+            uint32_t name_length = 0, name_pad = 0;
+            const char* name = nullptr;
+            if (!in.get(entry.size) || !in.get(entry.mtime) || !in.get(offset) || !in.get(length) ||
+                !in.get(name_length) || !in.get(name_pad) || !in.array(name, name_length) || !in.alignTo(8)) {
+                return false;
+            }
+            if (offset > file.size() || length > file.size() - offset) return false;
+            entry.name.assign(name, name_length);
+            entry.data = file.data() + offset;
+            entry.length = static_cast<size_t>(length);
+            entries[entry.name] = entry;
+        }
+        return true;
+    }
+
+    static bool writeCache(const std::filesystem::path& path, const std::vector<Entry>& entries) {
+        std::vector<char> header(kMagic, kMagic + sizeof(kMagic));
+        put(header, kVersion);
+        put(header, static_cast<uint32_t>(entries.size()));
+        put(header, static_cast<uint32_t>(sizeof(CompiledRule)));
+        put(header, static_cast<uint32_t>(sizeof(DegreeTerm)));
+        put(header, static_cast<uint32_t>(sizeof(ExactTerm)));
+        put(header, uint32_t(0));
+
+        // Blocks follow the entry table, so its size decides their offsets
+        size_t table_size = header.size();
+        for (const auto& entry : entries) table_size += 40 + align(entry.name.size(), 8);
+        uint64_t offset = table_size;
+        for (const auto& entry : entries) {
+            put(header, entry.size);
+            put(header, entry.mtime);
+            put(header, offset);
+            put(header, static_cast<uint64_t>(entry.length));
+            put(header, static_cast<uint32_t>(entry.name.size()));
+            put(header, uint32_t(0));
+            header.insert(header.end(), entry.name.begin(), entry.name.end());
+            pad(header, 8);
+            offset += align(entry.length, 8);
+        }
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        out.write(header.data(), header.size());
+        static const char zeros[8] = {};
+        for (const auto& entry : entries) {
+            out.write(entry.data, entry.length);
+            out.write(zeros, align(entry.length, 8) - entry.length);
+        }
+        out.close();
+        if (!out) {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+            return false;
+        }
+        return true;
+    }
+
+    MappedFile map;
+    std::vector<std::vector<char>> owned; // blocks parsed this run, until the cache is rewritten
+    std::vector<FileView> views;
+    std::unordered_map<std::string, Entry> loaded; // entries behind views, for the next open
+    std::filesystem::path loaded_path;             // cache file they belong to
+};
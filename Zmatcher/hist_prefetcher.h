@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "../common/data_frame.h"
+#include "../common/thread_pool.h"
+
+// Bounded read-ahead over the historical files. Reads run as pool tasks
+// while the caller matches the file before them, so parsing and matching
+// overlap. At most depth files past the one being matched are read or
+// held, which caps the memory taken by files that are not matched yet.
+class HistPrefetcher {
+public:
+    using Load = std::function<DataFrame(const std::filesystem::path&)>;
+
+    static constexpr size_t kDefaultDepth = 2;
+
+    HistPrefetcher(ThreadPool& pool, const std::vector<std::filesystem::path>& files, Load load, size_t depth = kDefaultDepth)
+        : pool(pool), files(files), load(std::move(load)), depth(depth == 0 ? 1 : depth) {
+        while (next < files.size() && pending.size() < this->depth) schedule();
+    }
+
+    HistPrefetcher(const HistPrefetcher&) = delete;
+    HistPrefetcher& operator=(const HistPrefetcher&) = delete;
+
+    // Reads still in flight refer to this object, so let them finish
+    ~HistPrefetcher() {
+        for (auto& read : pending) {
+            if (read.valid()) read.wait();
+        }
+    }
+
+    bool done() const { return pending.empty(); }
+
+    // Rows of the next file, in file order; throws what the load threw
+    DataFrame take() {
+        if (pending.empty()) throw std::logic_error("HistPrefetcher: no file left");
+        std::future<DataFrame> read = std::move(pending.front());
+        pending.pop_front();
+        // Refill first so the next read runs while this file is matched
+        if (next < files.size()) schedule();
+        return pool.wait(read);
+    }
+
+private:
+    void schedule() {
+        const std::filesystem::path& path = files[next++];
+        pending.push_back(pool.submit([this, &path] { return load(path); }));
+    }
+
+    ThreadPool& pool;
+    const std::vector<std::filesystem::path>& files;
+    Load load;
+    size_t depth;
+    size_t next = 0;
+    std::deque<std::future<DataFrame>> pending;
+};
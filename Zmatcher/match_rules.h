@@ -0,0 +1,189 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../common/data_frame.h"
+#include "../common/numeric_parse.h"
+#include "../common/string_pool.h"
+#include "daily_index.h"
+
+// Column definitions
+inline const std::vector<std::string> daily_cols = {
+    "AP", "AQ", "AR", "AS", "AT", "AU", "AV", "AW", "AX", "AY", "AZ",
+    "BA", "BB", "BC", "BD", "BE", "BF", "BG", "BH", "BI", "BJ", "BK"
+};
+
+inline const std::vector<std::string> degree_cols = {
+    "AQ", "AS", "AU", "AW", "AY", "BA", "BC", "BE", "BG", "BI", "BK"
+};
+
+// Position of a column name inside daily_cols, or -1. The filtered daily row
+// stores that column at index position + 1 (index 0 is the player).
+inline int dailyColumnPosition(std::string_view name) {
+    static const std::array<int8_t, 26 * 26> table = [] {
+        std::array<int8_t, 26 * 26> t{};
+        t.fill(-1);
+        for (size_t i = 0; i < daily_cols.size(); ++i) {
+            t[(daily_cols[i][0] - 'A') * 26 + (daily_cols[i][1] - 'A')] = static_cast<int8_t>(i);
+        }
+        return t;
+    }();
+    if (name.size() != 2) return -1;
+    unsigned a = static_cast<unsigned char>(name[0]) - 'A';
+    unsigned b = static_cast<unsigned char>(name[1]) - 'A';
+    if (a >= 26 || b >= 26) return -1;
+    return table[a * 26 + b];
+}
+
+inline bool isDegreeColumn(size_t position) {
+    // AQ, AS, ..., BK are every second column of daily_cols
+    return position % 2 == 1;
+}
+
+// Parses a historical degree range of the exact form "<digits>-<digits>".
+inline bool parseDegreeRange(std::string_view text, int32_t& low, int32_t& high) {
+    size_t dash = text.find('-');
+    if (dash == std::string_view::npos || dash == 0 || dash + 1 == text.size()) return false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (i != dash && (text[i] < '0' || text[i] > '9')) return false;
+    }
+    int32_t parsed_low = 0, parsed_high = 0;
+    if (!parseInt(text.substr(0, dash), parsed_low) || !parseInt(text.substr(dash + 1), parsed_high)) return false;
+    low = parsed_low;
+    high = parsed_high;
+    return true;
+}
+
+// Daily cells pre-parsed once per run: the interned string for exact columns
+// and the integer value for degree columns.
+struct DailyCell {
+    uint32_t code = StringPool::npos;
+    int32_t value = 0;
+    bool present = false; // column exists in the row and is not empty
+    bool has_int = false;
+};
+
+class DailyTable {
+public:
+    static constexpr size_t kColumns = 22;
+
+    void build(const DataFrame& daily_df) {
+        cells.assign(daily_df.size() * kColumns, DailyCell());
+        for (size_t i = 0; i < daily_df.size(); ++i) {
+            const Row& row = daily_df[i];
+            for (size_t col = 0; col < kColumns; ++col) {
+                size_t col_idx = col + 1; // +1 for Player column
+                if (col_idx >= row.size() || row[col_idx].empty()) continue;
+                DailyCell& cell = cells[i * kColumns + col];
+                cell.present = true;
+                cell.code = values.intern(row[col_idx]);
+                cell.has_int = parseInt(row[col_idx], cell.value);
+            }
+        }
+    }
+
+    const DailyCell* row(size_t i) const { return cells.data() + i * kColumns; }
+    const StringPool& valuePool() const { return values; }
+
+private:
+    StringPool values;
+    std::vector<DailyCell> cells;
+};
+
+// A historical row compiled down to what the matcher needs. Degree and exact
+// terms live in the RuleSet's flat arrays.
+struct DegreeTerm {
+    uint8_t col;   // position in daily_cols
+    int32_t low;   // empty range (low > high) when the historical value is not "N-M"
+    int32_t high;
+};
+
+struct ExactTerm {
+    uint8_t col;
+    uint32_t code; // code in DailyTable's value pool, npos if no daily cell has it
+};
+
+struct CompiledRule {
+    uint32_t player;     // code in DailyIndex's player pool
+    uint32_t hist_row;   // row index in the source file
+    uint32_t first_degree;
+    uint16_t degree_count;
+    uint16_t exact_count;
+    uint32_t first_exact;
+};
+
+class RuleSet {
+public:
+    std::vector<CompiledRule> rules;
+    std::vector<DegreeTerm> degree_terms;
+    std::vector<ExactTerm> exact_terms;
+
+    void clear() {
+        rules.clear();
+        degree_terms.clear();
+        exact_terms.clear();
+    }
+
+    // Compiles one historical row laid out as Player, (column, value) pairs...,
+    // Total, WinPercent. Returns false when no daily row can match it (its
+    // player is not in today's file), in which case nothing is added.
+    bool compile(const Row& row, uint32_t hist_row, const DailyIndex& daily_index, const DailyTable& daily_table) {
+        return compileWith(row, hist_row,
+            [&](const std::string& player) { return daily_index.playerId(player); },
+            [&](const std::string& value) { return daily_table.valuePool().find(value); });
+    }
+
+    // Same as compile, with player and value codes taken from any dictionary.
+    // player_of returning npos drops the row.
+    template <typename PlayerOf, typename ValueOf>
+    bool compileWith(const Row& row, uint32_t hist_row, PlayerOf&& player_of, ValueOf&& value_of) {
+        if (row.empty()) return false;
+        uint32_t player = player_of(row[0]);
+        if (player == StringPool::npos) return false;
+
+        // Later pairs for the same column overwrite earlier ones
+        std::array<const std::string*, DailyTable::kColumns> values{};
+        for (size_t i = 1; i + 2 < row.size(); i += 2) {
+            int pos = dailyColumnPosition(row[i]);
+            if (pos >= 0) values[pos] = &row[i + 1];
+        }
+
+        CompiledRule rule{ player, hist_row,
+            static_cast<uint32_t>(degree_terms.size()), 0, 0,
+            static_cast<uint32_t>(exact_terms.size()) };
+        for (size_t col = 0; col < values.size(); ++col) {
+            if (values[col] == nullptr || values[col]->empty()) continue;
+            if (isDegreeColumn(col)) {
+                DegreeTerm term{ static_cast<uint8_t>(col), 1, 0 };
+                parseDegreeRange(*values[col], term.low, term.high);
+                degree_terms.push_back(term);
+                rule.degree_count++;
+            }
+            else {
+                exact_terms.push_back({ static_cast<uint8_t>(col), value_of(*values[col]) });
+                rule.exact_count++;
+            }
+        }
+        rules.push_back(rule);
+        return true;
+    }
+
+    // A term passes when the daily cell is missing or empty, as before.
+    bool matches(const CompiledRule& rule, const DailyCell* daily) const {
+        const DegreeTerm* degree = degree_terms.data() + rule.first_degree;
+        for (uint16_t t = 0; t < rule.degree_count; ++t) {
+            const DailyCell& cell = daily[degree[t].col];
+            if (!cell.present) continue;
+            if (!cell.has_int || cell.value < degree[t].low || cell.value > degree[t].high) return false;
+        }
+        const ExactTerm* exact = exact_terms.data() + rule.first_exact;
+        for (uint16_t t = 0; t < rule.exact_count; ++t) {
+            const DailyCell& cell = daily[exact[t].col];
+            if (cell.present && cell.code != exact[t].code) return false;
+        }
+        return true;
+    }
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include "match_rules.h"
+
+// Reverse-join index over compiled rules. Every rule is filed under a single
+// anchor term keyed on (player, column, value/range); a daily row probes the
+// index and only the rules whose anchor it satisfies are verified in full.
+// Work per daily row grows with the number of candidates, not with history.
+class RuleIndex {
+public:
+    void build(const RuleSet& rule_set) {
+        rules = &rule_set;
+        exact_anchors.clear();
+        degree_anchors.clear();
+        player_anchors.clear();
+
+        for (uint32_t r = 0; r < rule_set.rules.size(); ++r) {
+            const CompiledRule& rule = rule_set.rules[r];
+            if (rule.exact_count > 0) {
+                const ExactTerm& term = rule_set.exact_terms[rule.first_exact];
+                exact_anchors.push_back({ rule.player, term.col, term.code, r });
+            }
+            else if (rule.degree_count > 0) {
+                const DegreeTerm& term = rule_set.degree_terms[rule.first_degree];
+                degree_anchors.push_back({ rule.player, term.col, term.low, term.high, r });
+            }
+            else {
+                player_anchors.push_back({ rule.player, r });
+            }
+        }
+
+        std::sort(exact_anchors.begin(), exact_anchors.end(), [](const ExactAnchor& a, const ExactAnchor& b) {
+            return std::tie(a.player, a.col, a.code, a.rule) < std::tie(b.player, b.col, b.code, b.rule);
+        });
+        std::sort(degree_anchors.begin(), degree_anchors.end(), [](const DegreeAnchor& a, const DegreeAnchor& b) {
+            return std::tie(a.player, a.col, a.low, a.rule) < std::tie(b.player, b.col, b.low, b.rule);
+        });
+        std::sort(player_anchors.begin(), player_anchors.end(), [](const PlayerAnchor& a, const PlayerAnchor& b) {
+            return std::tie(a.player, a.rule) < std::tie(b.player, b.rule);
+        });
+    }
+
+    // Calls on_match(rule_index) for every rule that matches the daily row.
+    template <typename F>
+    void probe(uint32_t player, const DailyCell* daily, F&& on_match) const {
+        auto verify = [&](uint32_t r) {
+            if (rules->matches(rules->rules[r], daily)) on_match(r);
+        };
+
+        auto players = std::equal_range(player_anchors.begin(), player_anchors.end(), PlayerAnchor{ player, 0 },
+            [](const PlayerAnchor& a, const PlayerAnchor& b) { return a.player < b.player; });
+        for (auto it = players.first; it != players.second; ++it) verify(it->rule);
+
+        for (uint8_t col = 0; col < DailyTable::kColumns; ++col) {
+            const DailyCell& cell = daily[col];
+            if (isDegreeColumn(col)) {
+                auto first = std::lower_bound(degree_anchors.begin(), degree_anchors.end(), std::make_pair(player, col),
+                    [](const DegreeAnchor& a, const std::pair<uint32_t, uint8_t>& key) {
+                        return std::tie(a.player, a.col) < std::tie(key.first, key.second);
+                    });
+                for (auto it = first; it != degree_anchors.end() && it->player == player && it->col == col; ++it) {
+                    // A missing daily cell passes the anchor term, so every rule here is a candidate
+                    if (cell.present) {
+                        if (!cell.has_int || it->low > cell.value) break;
+                        if (it->high < cell.value) continue;
+                    }
+                    verify(it->rule);
+                }
+            }
+            else {
+                auto first = std::lower_bound(exact_anchors.begin(), exact_anchors.end(), std::make_tuple(player, col, cell.code),
+                    [&](const ExactAnchor& a, const std::tuple<uint32_t, uint8_t, uint32_t>& key) {
+                        if (!cell.present) return std::tie(a.player, a.col) < std::tie(std::get<0>(key), std::get<1>(key));
+                        return std::tie(a.player, a.col, a.code) < key;
+                    });
+                for (auto it = first; it != exact_anchors.end() && it->player == player && it->col == col; ++it) {
+                    if (cell.present && it->code != cell.code) break;
+                    verify(it->rule);
+                }
+            }
+        }
+    }
+
+private:
+    struct ExactAnchor {
+        uint32_t player;
+        uint8_t col;
+        uint32_t code;
+        uint32_t rule;
+    };
+
+    struct DegreeAnchor {
+        uint32_t player;
+        uint8_t col;
+        int32_t low;
+        int32_t high;
+        uint32_t rule;
+    };
+
+    struct PlayerAnchor {
+        uint32_t player;
+        uint32_t rule;
+    };
+
+    const RuleSet* rules = nullptr;
+    std::vector<ExactAnchor> exact_anchors;
+    std::vector<DegreeAnchor> degree_anchors;
+    std::vector<PlayerAnchor> player_anchors;
+};
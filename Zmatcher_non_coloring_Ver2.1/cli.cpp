@@ -0,0 +1,72 @@
+// Console front end of the non-coloring matcher, for batch servers and cron.
+//
+// zmatcher_nc --daily FILE --hist FOLDER [--output FILE] [--format csv|xlsx]
+//             [--threads N] [--index] [--quiet]
+
+#include <iostream>
+#include <string>
+#include "../common/cli_args.h"
+#include "../common/console_progress.h"
+#include "../common/progress.h"
+#include "matching.h"
+
+namespace {
+
+const char* kUsage =
+    "Usage: zmatcher_nc --daily FILE --hist FOLDER [options]\n"
+    "\n"
+    "Matches the daily file against every row of the .csv/.xlsx files in FOLDER.\n"
+    "\n"
+    "Options:\n"
+    "  --output FILE      output file (default <daily>_Matches.<format>)\n"
+    "  --format csv|xlsx  output format when --output is not given (default csv)\n"
+    "  --threads N        worker threads, 0 for all cores (default 0)\n"
+    "  --index            use the index engine\n"
+    "  --quiet            no progress on stderr\n";
+
+std::string formatProgress(const Progress::Snapshot& shot) {
+    if (shot.total == 0) return shot.status;
+    return shot.status + " " + std::to_string(shot.done) + "/" + std::to_string(shot.total) + ", " +
+        std::to_string(shot.matches) + " matches";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        CliArgs args(argc, argv, { "--daily", "--hist", "--output", "--format", "--threads" }, { "--index", "--quiet" });
+        if (args.flag("--help")) {
+            std::cout << kUsage;
+            return 0;
+        }
+        std::filesystem::path daily_file = std::filesystem::u8path(args.require("--daily"));
+        std::filesystem::path hist_folder = std::filesystem::u8path(args.require("--hist"));
+        std::filesystem::path out_path = args.has("--output")
+            ? std::filesystem::u8path(args.get("--output"))
+            : DefaultOutputPath(daily_file, args.format("csv"));
+
+        Progress progress;
+        progress.start();
+        ConsoleProgress reporter(progress, formatProgress, !args.flag("--quiet"));
+        MatchSummary summary = ProcessMatching(daily_file, hist_folder, out_path, args.flag("--index"), args.threads(), progress);
+        progress.finish();
+        reporter.stop();
+
+        if (summary.matches > 0) {
+            std::cout << "Processing finished. Found " << summary.matches << " matches. Output: " << out_path.u8string() << std::endl;
+        }
+        else {
+            std::cout << "NO Matches found... Processed " << summary.hist_rows << " historical rows against "
+                << summary.daily_rows << " daily rows" << std::endl;
+        }
+        return 0;
+    }
+    catch (const UsageError& e) {
+        std::cerr << e.what() << "\n\n" << kUsage;
+        return 2;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
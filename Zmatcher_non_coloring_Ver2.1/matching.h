@@ -0,0 +1,385 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cwctype>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "../common/csv_manager.h"
+#include "../common/match_writer.h"
+#include "../common/numeric_parse.h"
+#include "../common/progress.h"
+#include "../common/string_pool.h"
+#include "../common/thread_pool.h"
+
+// Matching core shared by the Win32 GUI (main.cpp) and the console tool
+// (cli.cpp). Reports through a Progress and throws on errors; it never
+// touches a window.
+
+// Constants matching Python script
+inline const std::vector<std::string> all_columns = { "Player", "AP", "AQ", "AR", "AS", "AT", "AU", "AV", "AW", "AX", "AY", "AZ", "BA", "BB", "BC", "BD", "BE", "BF", "BG", "BH", "BI", "BJ", "BK" };
+inline const std::vector<std::string> daily_cols = { "AP", "AQ", "AR", "AS", "AT", "AU", "AV", "AW", "AX", "AY", "AZ", "BA", "BB", "BC", "BD", "BE", "BF", "BG", "BH", "BI", "BJ", "BK" };
+inline const std::vector<std::string> degree_cols = { "AQ","AS","AU", "AW", "AY", "BA", "BC", "BE", "BG", "BI", "BK" };
+
+// Helper: filter daily data to columns 0 and 41-62 (matching Python script)
+inline DataFrame FilterDailyData(const DataFrame& raw_daily_df) {
+    DataFrame filtered_data;
+    for (const Row& row : raw_daily_df) {
+        Row filtered_row;
+        if (!row.empty()) filtered_row.push_back(row[0]); // Player column
+        for (int i = 41; i <= 62 && i < static_cast<int>(row.size()); ++i) {
+            filtered_row.push_back(row[i]);
+        }
+        if (!filtered_row.empty()) filtered_data.push_back(filtered_row);
+    }
+    return filtered_data;
+}
+
+// Helper: get column index from column name in daily_df
+inline size_t GetColumnIndex(const std::string& col_name) {
+    auto it = std::find(all_columns.begin(), all_columns.end(), col_name);
+    if (it != all_columns.end()) {
+        return std::distance(all_columns.begin(), it);
+    }
+    return SIZE_MAX; // Column not found
+}
+
+// Helper: parse row to dictionary (matching Python parse_row_to_dict function)
+inline std::map<std::string, std::string> ParseRowToDict(const Row& row) {
+    std::map<std::string, std::string> data;
+    if (row.size() < 4) return data;
+    
+    data["Player"] = row[0];
+    
+    // Process key-value pairs (skip last 4: Count, Total, WinTotal, WinPercent)
+    for (size_t i = 1; i + 1 < row.size() - 4; i += 2) {
+        if (i + 1 < row.size()) {
+            data[row[i]] = row[i + 1];
+        }
+    }
+    
+    // Add the last 4 fields
+    if (row.size() >= 4) {
+        data["Count"] = row[row.size() - 4];
+        data["Total"] = row[row.size() - 3];
+        data["WinTotal"] = row[row.size() - 2];
+        data["WinPercent"] = row[row.size() - 1];
+    }
+    
+    return data;
+}
+
+// Helper: check if two values match (matching Python logic)
+inline bool ValuesMatch(const std::string& daily_val, const std::string& hist_val) {
+    if (daily_val.empty() || hist_val.empty()) return false;
+    
+    int32_t daily_int = 0, hist_int = 0;
+    return parseInt(daily_val, daily_int) && parseInt(hist_val, hist_int) && daily_int == hist_int;
+}
+
+
+
+// Index engine: every historical row becomes a list of (column, value) terms
+// with the same skip rules as the scan above, filed under its first term.
+// Each daily row then probes only the rules anchored on one of its own cells.
+struct ExactTerm {
+    uint8_t col;   // position in all_columns, 0 is Player
+    uint32_t code; // code in the daily value pool, npos if no daily cell has it
+};
+
+struct HistRule {
+    uint32_t first_term;
+    uint32_t term_count;
+};
+
+class HistIndex {
+public:
+    void build(const std::vector<std::pair<size_t, Row>>& all_rows, const DataFrame& daily_df) {
+        // Intern every daily cell so rule terms compare codes only
+        daily_codes.assign(daily_df.size() * all_columns.size(), StringPool::npos);
+        daily_sizes.resize(daily_df.size());
+        for (size_t i = 0; i < daily_df.size(); ++i) {
+            daily_sizes[i] = daily_df[i].size();
+            for (size_t col = 0; col < daily_df[i].size() && col < all_columns.size(); ++col) {
+                daily_codes[i * all_columns.size() + col] = values.intern(daily_df[i][col]);
+            }
+        }
+
+        for (uint32_t r = 0; r < all_rows.size(); ++r) {
+            const Row& row = all_rows[r].second;
+            HistRule rule{ static_cast<uint32_t>(terms.size()), 0 };
+            if (row.size() >= 4) {
+                // Last assignment wins, as with the map in ParseRowToDict
+                std::vector<const std::string*> cols(all_columns.size(), nullptr);
+                cols[0] = &row[0];
+                for (size_t i = 1; i + 1 < row.size() - 4; i += 2) {
+                    size_t col_idx = GetColumnIndex(row[i]);
+                    if (col_idx != SIZE_MAX) cols[col_idx] = &row[i + 1];
+                }
+                for (size_t col = 0; col < cols.size(); ++col) {
+                    if (cols[col] == nullptr || cols[col]->empty() || *cols[col] == "0") continue;
+                    terms.push_back({ static_cast<uint8_t>(col), values.find(*cols[col]) });
+                    rule.term_count++;
+                }
+            }
+            if (rule.term_count == 0) {
+                match_all.push_back(r);
+            }
+            else {
+                anchors.push_back({ terms[rule.first_term].col, terms[rule.first_term].code, r });
+            }
+            rules.push_back(rule);
+        }
+        std::sort(anchors.begin(), anchors.end(), [](const Anchor& a, const Anchor& b) {
+            return std::tie(a.col, a.code, a.rule) < std::tie(b.col, b.code, b.rule);
+        });
+    }
+
+    // Calls on_match(rule) for every historical row that matches daily row i.
+    template <typename F>
+    void probe(size_t i, F&& on_match) const {
+        const uint32_t* daily = daily_codes.data() + i * all_columns.size();
+        auto verify = [&](uint32_t r) {
+            const ExactTerm* term = terms.data() + rules[r].first_term;
+            for (uint32_t t = 0; t < rules[r].term_count; ++t) {
+                // Columns past the end of the daily row are skipped by the scan
+                if (term[t].col < daily_sizes[i] && daily[term[t].col] != term[t].code) return;
+            }
+            on_match(r);
+        };
+
+        for (uint32_t r : match_all) verify(r);
+        for (uint8_t col = 0; col < all_columns.size(); ++col) {
+            auto first = std::lower_bound(anchors.begin(), anchors.end(), col,
+                [](const Anchor& a, uint8_t key) { return a.col < key; });
+            if (col < daily_sizes[i]) {
+                first = std::lower_bound(first, anchors.end(), daily[col],
+                    [col](const Anchor& a, uint32_t key) { return a.col == col && a.code < key; });
+            }
+            for (auto it = first; it != anchors.end() && it->col == col; ++it) {
+                if (col < daily_sizes[i] && it->code != daily[col]) break;
+                verify(it->rule);
+            }
+        }
+    }
+
+private:
+    struct Anchor {
+        uint8_t col;
+        uint32_t code;
+        uint32_t rule;
+    };
+
+    StringPool values;
+    std::vector<uint32_t> daily_codes;
+    std::vector<size_t> daily_sizes;
+    std::vector<HistRule> rules;
+    std::vector<ExactTerm> terms;
+    std::vector<Anchor> anchors;
+    std::vector<uint32_t> match_all;
+};
+
+// (historical row in all_rows, daily row) pair; the output row is the raw
+// daily row followed by the historical row
+using MatchPair = std::pair<uint32_t, uint32_t>;
+
+// Same pairs as the scan in ProcessMatching, ordered by historical row and
+// then by daily row.
+inline std::vector<MatchPair> MatchWithIndex(ThreadPool& pool, const std::vector<std::pair<size_t, Row>>& all_rows, const DataFrame& daily_df, Progress& progress) {
+    HistIndex index;
+    index.build(all_rows, daily_df);
+
+    progress.setStatus("Probing daily rows...");
+    progress.beginPhase(daily_df.size());
+
+    // Daily rows are probed in parallel chunks; the sort fixes the order
+    size_t grain = pool.grainFor(daily_df.size());
+    std::vector<std::vector<MatchPair>> chunk_pairs((daily_df.size() + grain - 1) / grain);
+    pool.parallelFor(0, daily_df.size(), grain, [&](size_t begin, size_t end) {
+        auto& found = chunk_pairs[begin / grain];
+        for (size_t i = begin; i < end; ++i) {
+            if (!daily_df[i].empty()) {
+                index.probe(i, [&](uint32_t r) { found.emplace_back(r, static_cast<uint32_t>(i)); });
+            }
+        }
+        progress.addDone(end - begin);
+        progress.addMatches(found.size());
+    });
+    std::vector<MatchPair> pairs;
+    for (const auto& found : chunk_pairs) pairs.insert(pairs.end(), found.begin(), found.end());
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+// Scan engine: appends a pair for every daily row that historical row r matches.
+inline void MatchHistRow(uint32_t r, const Row& hist_row, const DataFrame& daily_df, std::vector<MatchPair>& pairs) {
+    std::map<std::string, std::string> row_dict = ParseRowToDict(hist_row);
+
+    // For each daily row, check match (matching Python logic)
+    for (size_t i = 0; i < daily_df.size(); ++i) {
+        const Row& daily_row = daily_df[i];
+        if (daily_row.empty()) continue;
+
+        bool is_match = true;
+
+        // Check each field in historical row
+        for (const auto& [col, hist_val] : row_dict) {
+            if (col == "Count" || col == "Total" || col == "WinTotal" || col == "WinPercent") {
+                continue; // Skip these fields as per Python script
+            }
+
+            // Skip if historical value is empty or 0 (same logic as Python)
+            if (hist_val.empty() || hist_val == "0") {
+                continue;
+            }
+
+            std::string daily_val;
+            if (col == "Player") {
+                daily_val = daily_row[0];
+                if (daily_val != hist_val) {
+                    is_match = false;
+                    break;
+                }
+            } else {
+                // Get the column index using the helper function
+                size_t col_idx = GetColumnIndex(col);
+                if (col_idx == SIZE_MAX || col_idx >= daily_row.size()) {
+                    continue; // Column not found or out of bounds
+                }
+
+                daily_val = daily_row[col_idx];
+
+                if (daily_val != hist_val) {
+                    is_match = false;
+                    break;
+                }
+            }
+        }
+
+        if (is_match) {
+            // Found match - daily and historical data are combined when written
+            pairs.emplace_back(r, static_cast<uint32_t>(i));
+        }
+    }
+}
+
+// Result of one ProcessMatching run
+struct MatchSummary {
+    size_t matches = 0;
+    size_t hist_rows = 0;
+    size_t daily_rows = 0;
+};
+
+// Matches output next to the daily file: <daily>_Matches.<format>
+inline std::filesystem::path DefaultOutputPath(const std::filesystem::path& daily_file, const std::string& format = "csv") {
+    std::filesystem::path output_path = daily_file;
+    output_path.replace_extension();
+    output_path += "_Matches." + format;
+    return output_path;
+}
+
+// Main processing logic (matching Python process_files function). Matches
+// are streamed to out_path (.csv or .xlsx), which is not created when
+// nothing matches. Runs on a pool of threads workers (0 for all cores) and
+// throws on errors.
+inline MatchSummary ProcessMatching(const std::filesystem::path& daily_file, const std::filesystem::path& hist_folder,
+    const std::filesystem::path& out_path, bool use_index, size_t threads, Progress& progress) {
+    progress.setStatus("Reading daily file...");
+    DataFrame raw_daily_df = CSVManager::read(daily_file);
+    DataFrame daily_df = FilterDailyData(raw_daily_df);
+    
+    // Debug: Log the data structure
+    if (!daily_df.empty()) {
+        progress.setStatus("Daily data: " + std::to_string(raw_daily_df.size()) + " rows, " +
+                           std::to_string(raw_daily_df[0].size()) + " columns. Filtered: " +
+                           std::to_string(daily_df.size()) + " rows, " + std::to_string(daily_df[0].size()) + " columns");
+    }
+    
+    // Debug: Show column mapping
+    if (!daily_df.empty() && !daily_df[0].empty()) {
+        progress.setStatus("Column mapping: 0->Player, 1->" + daily_cols[0] + ", 2->" + daily_cols[1] + ", 3->" + daily_cols[2]);
+    }
+    
+    // Set column labels for daily_df (matching Python script)
+    // daily_df columns are: Player, AP, AQ, AR, AS, AT, AU, AV, AW, AX, AY, AZ, BA, BB, BC, BD, BE, BF, BG, BH, BI, BJ, BK
+    // This corresponds to original columns: 0, 41, 42, 43, ..., 62
+
+    std::vector<std::pair<size_t, Row>> all_rows;
+    
+    // Collect all historical rows (matching Python script). Files are
+    // read in parallel and appended in directory order.
+    std::vector<std::filesystem::path> hist_files;
+    for (const auto& entry : std::filesystem::directory_iterator(hist_folder)) {
+        if (!entry.is_regular_file()) continue;
+        std::wstring ext = entry.path().extension().wstring();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::towlower);
+        if (ext != L".csv" && ext != L".xlsx") continue;
+        hist_files.push_back(entry.path());
+    }
+
+    ThreadPool pool(threads);
+    std::vector<std::future<DataFrame>> file_reads;
+    for (const auto& path : hist_files) {
+        file_reads.push_back(pool.submit([path, &progress]() {
+            progress.addBytes(std::filesystem::file_size(path));
+            return CSVManager::read(path);
+            }));
+    }
+    progress.beginPhase(hist_files.size());
+    for (size_t f = 0; f < hist_files.size(); ++f) {
+        progress.setStatus("Reading: " + CSVManager::ws2s(hist_files[f].filename().wstring()));
+        DataFrame raw_hist_df = pool.wait(file_reads[f]);
+        progress.addDone();
+        progress.addRows(raw_hist_df.size());
+        for (size_t idx = 0; idx < raw_hist_df.size(); ++idx) {
+            all_rows.push_back({idx, std::move(raw_hist_df[idx])});
+        }
+    }
+    
+    // Matches are streamed to the output as they are found
+    MatchWriter match_writer(out_path);
+    auto write_pairs = [&](const std::vector<MatchPair>& pairs) {
+        for (const auto& [r, i] : pairs) match_writer.write(raw_daily_df[i], all_rows[r].second);
+    };
+
+    if (use_index) {
+        progress.setStatus("Indexing historical rows...");
+        write_pairs(MatchWithIndex(pool, all_rows, daily_df, progress));
+    }
+    else {
+        progress.setStatus("Matching historical rows...");
+        progress.beginPhase(all_rows.size());
+    
+        // Process each historical row (matching Python multiprocess_rows logic).
+        // Rows go in blocks: a block is matched in parallel chunks, then
+        // its pairs are written in row order before the next block.
+        size_t block_rows = pool.size() * 256;
+        for (size_t block = 0; block < all_rows.size(); block += block_rows) {
+            size_t block_end = std::min(all_rows.size(), block + block_rows);
+            size_t grain = pool.grainFor(block_end - block);
+            std::vector<std::vector<MatchPair>> chunk_pairs((block_end - block + grain - 1) / grain);
+            pool.parallelFor(block, block_end, grain, [&](size_t begin, size_t end) {
+                std::vector<MatchPair>& pairs = chunk_pairs[(begin - block) / grain];
+                for (size_t r = begin; r < end; ++r) {
+                    try {
+                        MatchHistRow(static_cast<uint32_t>(r), all_rows[r].second, daily_df, pairs);
+                    } catch (const std::exception&) {
+                        // Continue processing other rows if one fails
+                    }
+                }
+                progress.addDone(end - begin);
+                progress.addMatches(pairs.size());
+            });
+            for (const auto& pairs : chunk_pairs) write_pairs(pairs);
+        }
+    }
+
+    // Finish output (matching Python script output format)
+    if (match_writer.count() > 0) match_writer.close();
+    return { match_writer.count(), all_rows.size(), daily_df.size() };
+}
@@ -0,0 +1,111 @@
+// Benchmark: CSV reading throughput, getline path vs CsvReader per scan kernel.
+//
+// Build: g++ -O2 -std=c++17 bench/csv_scan_bench.cpp -o csv_scan_bench
+// Usage: csv_scan_bench [megabytes] [file]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include "../common/csv_reader.h"
+
+namespace {
+
+// Historical rows as Counter writes them: Player, (column, value) pairs, Total, WinPercent
+void writeHistFile(const std::string& path, size_t bytes) {
+    static const char* cols[] = { "AP", "AQ", "AR", "AS", "AT", "AU", "AV", "AW", "AX", "AY", "AZ" };
+    std::mt19937 rng(42);
+    std::ofstream out(path, std::ios::binary);
+    size_t written = 0;
+    std::string line;
+    while (written < bytes) {
+        line = "Player " + std::to_string(rng() % 3000) + " Jr.";
+        int pairs = 3 + rng() % 4;
+        for (int i = 0; i < pairs; ++i) {
+            int col = rng() % 11;
+            line += ',';
+            line += cols[col];
+            line += ',';
+            if (col % 2 == 1) {
+                int low = rng() % 10;
+                line += std::to_string(low) + "-" + std::to_string(low + rng() % 10);
+            }
+            else {
+                line += std::to_string(rng() % 9);
+            }
+        }
+        line += "," + std::to_string(rng() % 500) + ",0." + std::to_string(rng() % 100) + "\n";
+        out << line;
+        written += line.size();
+    }
+}
+
+// The reader every tool used before CsvReader
+size_t readGetline(const std::string& path) {
+    size_t cells = 0;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string cell;
+        Row row;
+        while (std::getline(ss, cell, ',')) {
+            cell.erase(std::remove(cell.begin(), cell.end(), '"'), cell.end());
+            cell.erase(0, cell.find_first_not_of(" \t"));
+            cell.erase(cell.find_last_not_of(" \t") + 1);
+            row.push_back(cell);
+        }
+        cells += row.size();
+    }
+    return cells;
+}
+
+// Best of three runs, so page cache warm-up does not favour later readers
+template <typename F>
+double timeSeconds(F&& f) {
+    double best = 0.0;
+    for (int run = 0; run < 3; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        double s = std::chrono::duration<double>(end - start).count();
+        if (run == 0 || s < best) best = s;
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 128;
+    std::string path = argc > 2 ? argv[2] : "csv_scan_bench.csv";
+    writeHistFile(path, megabytes << 20);
+    double gigabytes = static_cast<double>(std::filesystem::file_size(path)) / 1e9;
+    std::printf("file %s, %.1f MB\n", path.c_str(), gigabytes * 1e3);
+
+    size_t expected = 0;
+    double getline_s = timeSeconds([&] { expected = readGetline(path); });
+    std::printf("%-8s: %8.3f s %7.2f GB/s\n", "getline", getline_s, gigabytes / getline_s);
+
+    int status = 0;
+    for (const CsvScanKernel& kernel : availableCsvKernels()) {
+        size_t cells = 0;
+        double s = timeSeconds([&] {
+            cells = 0;
+            CsvReader reader(path, kernel);
+            reader.forEachRow([&](const std::vector<std::string_view>& row) { cells += row.size(); });
+        });
+        std::printf("%-8s: %8.3f s %7.2f GB/s (%.1fx getline)\n", kernel.name, s, gigabytes / s, getline_s / s);
+        if (cells != expected) {
+            std::printf("MISMATCH: %s read %zu cells, getline %zu\n", kernel.name, cells, expected);
+            status = 1;
+        }
+    }
+    std::printf("runtime dispatch picks %s\n", bestCsvKernel().name);
+    std::remove(path.c_str());
+    return status;
+}
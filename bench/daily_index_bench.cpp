@@ -0,0 +1,91 @@
+// Benchmark: Zmatcher player lookup, nested loop vs DailyIndex.
+//
+// Build: g++ -O2 -std=c++17 bench/daily_index_bench.cpp -o daily_index_bench
+// Usage: daily_index_bench [daily_rows] [hist_rows] [players]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include "../Zmatcher/daily_index.h"
+
+namespace {
+
+std::string playerName(std::mt19937& rng, int players) {
+    std::uniform_int_distribution<int> pick(0, players - 1);
+    return "Player " + std::to_string(pick(rng)) + " Jr.";
+}
+
+DataFrame makeDaily(size_t rows, int players, std::mt19937& rng) {
+    DataFrame df;
+    df.reserve(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        Row row(23, "5");
+        row[0] = playerName(rng, players);
+        df.push_back(std::move(row));
+    }
+    return df;
+}
+
+DataFrame makeHist(size_t rows, int players, std::mt19937& rng) {
+    DataFrame df;
+    df.reserve(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        df.push_back({ playerName(rng, players), "AQ", "1-5", "AS", "3-9", "10", "0.55" });
+    }
+    return df;
+}
+
+template <typename F>
+double timeMs(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t daily_rows = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000;
+    size_t hist_rows = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+    int players = argc > 3 ? std::atoi(argv[3]) : 1500;
+
+    std::mt19937 rng(42);
+    DataFrame daily_df = makeDaily(daily_rows, players, rng);
+    DataFrame hist_df = makeHist(hist_rows, players, rng);
+
+    // Today's loop: every historical row scans every daily row
+    size_t nested_hits = 0;
+    double nested_ms = timeMs([&] {
+        for (const Row& hist_row : hist_df) {
+            for (size_t i = 0; i < daily_df.size(); ++i) {
+                if (daily_df[i][0] != hist_row[0]) continue;
+                nested_hits += i & 1;
+            }
+        }
+    });
+
+    size_t index_hits = 0;
+    double build_ms = 0.0;
+    double index_ms = timeMs([&] {
+        DailyIndex daily_index;
+        build_ms = timeMs([&] { daily_index.build(daily_df); });
+        for (const Row& hist_row : hist_df) {
+            for (uint32_t i : daily_index.rowsFor(hist_row[0])) {
+                index_hits += i & 1;
+            }
+        }
+    });
+
+    std::printf("daily rows %zu, historical rows %zu, players %d\n", daily_rows, hist_rows, players);
+    std::printf("nested loop : %10.2f ms\n", nested_ms);
+    std::printf("daily index : %10.2f ms (build %.3f ms)\n", index_ms, build_ms);
+    std::printf("speedup     : %10.1fx\n", nested_ms / index_ms);
+    if (nested_hits != index_hits) {
+        std::printf("MISMATCH: nested %zu vs index %zu\n", nested_hits, index_hits);
+        return 1;
+    }
+    return 0;
+}
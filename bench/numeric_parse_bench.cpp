@@ -0,0 +1,114 @@
+// Benchmark: cell number parsing, std::stoi/std::stod in try/catch vs the
+// fast_float based parseInt/parseDouble.
+//
+// Build: g++ -O2 -std=c++17 -Iassets/include bench/numeric_parse_bench.cpp -o numeric_parse_bench
+// Usage: numeric_parse_bench [cells] [percent_non_numeric]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "../common/numeric_parse.h"
+
+namespace {
+
+// Degree cells as the tools see them: small integers, win percents, and a
+// share of blank and textual cells that make std::stoi throw
+std::vector<std::string> makeCells(size_t count, int percent_non_numeric) {
+    static const char* text[] = { "", "", " ", "N/A", "Player 7 Jr.", "over", "-" };
+    std::mt19937 rng(42);
+    std::vector<std::string> cells;
+    cells.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (static_cast<int>(rng() % 100) < percent_non_numeric) {
+            cells.push_back(text[rng() % 7]);
+        }
+        else if (rng() % 4 == 0) {
+            cells.push_back("0." + std::to_string(rng() % 100));
+        }
+        else {
+            cells.push_back(std::to_string(rng() % 40));
+        }
+    }
+    return cells;
+}
+
+// The helper every tool used: safeStoi in Counter, ValuesMatch, mapToRange
+int stoiOrZero(const std::string& cell) {
+    try {
+        return std::stoi(cell);
+    }
+    catch (...) {
+        return 0;
+    }
+}
+
+double stodOrZero(const std::string& cell) {
+    try {
+        return std::stod(cell);
+    }
+    catch (...) {
+        return 0.0;
+    }
+}
+
+// Best of three runs
+template <typename F>
+double timeSeconds(F&& f) {
+    double best = 0.0;
+    for (int run = 0; run < 3; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        double s = std::chrono::duration<double>(end - start).count();
+        if (run == 0 || s < best) best = s;
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000000;
+    int percent_non_numeric = argc > 2 ? std::atoi(argv[2]) : 30;
+    std::vector<std::string> cells = makeCells(count, percent_non_numeric);
+    std::printf("%zu cells, %d%% non-numeric\n", count, percent_non_numeric);
+
+    long long stoi_sum = 0, parse_int_sum = 0;
+    double stod_sum = 0.0, parse_double_sum = 0.0;
+    double stoi_s = timeSeconds([&] {
+        stoi_sum = 0;
+        for (const std::string& cell : cells) stoi_sum += stoiOrZero(cell);
+    });
+    double parse_int_s = timeSeconds([&] {
+        parse_int_sum = 0;
+        for (const std::string& cell : cells) parse_int_sum += parseIntOr(cell, 0);
+    });
+    double stod_s = timeSeconds([&] {
+        stod_sum = 0.0;
+        for (const std::string& cell : cells) stod_sum += stodOrZero(cell);
+    });
+    double parse_double_s = timeSeconds([&] {
+        parse_double_sum = 0.0;
+        for (const std::string& cell : cells) {
+            double value = 0.0;
+            parseDouble(cell, value);
+            parse_double_sum += value;
+        }
+    });
+
+    double mcells = static_cast<double>(count) / 1e6;
+    std::printf("%-12s: %8.3f s %8.1f Mcells/s\n", "std::stoi", stoi_s, mcells / stoi_s);
+    std::printf("%-12s: %8.3f s %8.1f Mcells/s (%.1fx)\n", "parseInt", parse_int_s, mcells / parse_int_s, stoi_s / parse_int_s);
+    std::printf("%-12s: %8.3f s %8.1f Mcells/s\n", "std::stod", stod_s, mcells / stod_s);
+    std::printf("%-12s: %8.3f s %8.1f Mcells/s (%.1fx)\n", "parseDouble", parse_double_s, mcells / parse_double_s, stod_s / parse_double_s);
+
+    int status = 0;
+    if (stoi_sum != parse_int_sum || stod_sum != parse_double_sum) {
+        std::printf("MISMATCH: int %lld vs %lld, double %.17g vs %.17g\n", stoi_sum, parse_int_sum, stod_sum, parse_double_sum);
+        status = 1;
+    }
+    return status;
+}
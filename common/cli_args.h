@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <initializer_list>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "numeric_parse.h"
+
+// Bad command line; the tools print their usage for it
+class UsageError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Command line of the console tools: "--name value" options, "--name"
+// flags and positional arguments. Names the tool does not know are an
+// error, so a typo does not silently fall back to a default.
+class CliArgs {
+public:
+    CliArgs(int argc, char** argv, std::initializer_list<const char*> options, std::initializer_list<const char*> flags) {
+        std::set<std::string> known_options(options.begin(), options.end());
+        std::set<std::string> known_flags(flags.begin(), flags.end());
+        known_flags.insert("--help");
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.size() < 2 || arg.compare(0, 2, "--") != 0) {
+                positional_args.push_back(arg);
+            }
+            else if (known_flags.count(arg)) {
+                set_flags.insert(arg);
+            }
+            else if (known_options.count(arg)) {
+                if (i + 1 >= argc) throw UsageError("Missing value for " + arg);
+                values[arg] = argv[++i];
+            }
+            else {
+                throw UsageError("Unknown option: " + arg);
+            }
+        }
+    }
+
+    bool flag(const std::string& name) const { return set_flags.count(name) > 0; }
+
+    bool has(const std::string& name) const { return values.count(name) > 0; }
+
+    std::string get(const std::string& name, const std::string& fallback = {}) const {
+        auto it = values.find(name);
+        return it != values.end() ? it->second : fallback;
+    }
+
+    std::string require(const std::string& name) const {
+        auto it = values.find(name);
+        if (it == values.end()) throw UsageError("Missing required option " + name);
+        return it->second;
+    }
+
+    int getInt(const std::string& name, int fallback) const {
+        auto it = values.find(name);
+        if (it == values.end()) return fallback;
+        int value = 0;
+        if (!parseInt(it->second, value)) throw UsageError("Not a number for " + name + ": " + it->second);
+        return value;
+    }
+
+    // --threads N; 0 (the default) uses every hardware thread
+    size_t threads() const {
+        int value = getInt("--threads", 0);
+        if (value < 0) throw UsageError("--threads must not be negative");
+        return static_cast<size_t>(value);
+    }
+
+    // --format csv|xlsx, lowercased; fallback when not given
+    std::string format(const std::string& fallback) const {
+        std::string value = get("--format", fallback);
+        std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (value != "csv" && value != "xlsx") throw UsageError("--format must be csv or xlsx");
+        return value;
+    }
+
+    const std::vector<std::string>& positional() const { return positional_args; }
+
+private:
+    std::map<std::string, std::string> values;
+    std::set<std::string> set_flags;
+    std::vector<std::string> positional_args;
+};
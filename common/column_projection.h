@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Columns a reader should materialize, by 0-based index or Excel letters.
+// Rows keep their positions and width; cells outside the projection come
+// out as empty strings and their bytes are skipped by the parser. The
+// default projection keeps every column.
+class ColumnProjection {
+public:
+    ColumnProjection() = default;
+
+    ColumnProjection(std::initializer_list<size_t> columns) : keep_all(false) {
+        for (size_t column : columns) add(column);
+    }
+
+    static ColumnProjection fromLetters(const std::vector<std::string>& letters) {
+        ColumnProjection projection{};
+        projection.keep_all = false;
+        for (const std::string& letter : letters) projection.add(columnIndex(letter));
+        return projection;
+    }
+
+    // "A" -> 0, "Z" -> 25, "AA" -> 26
+    static size_t columnIndex(std::string_view letters) {
+        if (letters.empty()) throw std::runtime_error("Empty column name");
+        size_t index = 0;
+        for (char c : letters) {
+            if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+            if (c < 'A' || c > 'Z') throw std::runtime_error("Invalid column name: " + std::string(letters));
+            index = index * 26 + static_cast<size_t>(c - 'A' + 1);
+        }
+        return index - 1;
+    }
+
+    void add(size_t column) {
+        keep_all = false;
+        if (column >= keep.size()) keep.resize(column + 1, false);
+        keep[column] = true;
+    }
+
+    void addLetters(std::string_view letters) { add(columnIndex(letters)); }
+
+    bool keepsAll() const { return keep_all; }
+
+    bool contains(size_t column) const {
+        return keep_all || (column < keep.size() && keep[column]);
+    }
+
+private:
+    bool keep_all = true;
+    std::vector<bool> keep;
+};
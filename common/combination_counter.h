@@ -0,0 +1,507 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "data_frame.h"
+#include "flat_hash_map.h"
+#include "numeric_parse.h"
+#include "packed_key.h"
+#include "string_pool.h"
+
+// Result column of a row: "win" counts as over and "lose" as under
+enum class Outcome : uint8_t { Other, Over, Under };
+
+inline Outcome classifyOutcome(std::string_view result) {
+    auto is = [&](std::string_view word) {
+        if (result.size() != word.size()) return false;
+        for (size_t i = 0; i < word.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(result[i])) != word[i]) return false;
+        }
+        return true;
+    };
+    if (is("over") || is("win")) return Outcome::Over;
+    if (is("under") || is("lose")) return Outcome::Under;
+    return Outcome::Other;
+}
+
+// The rows of one input file as integer codes: the player and one code per
+// counted column, interned once so counting hashes integers and only the
+// output decodes strings. Every column has its own codes, so they stay as
+// small as the column's distinct values. Rows with fewer than 8 cells or
+// an outcome other than over/under are left out; they never reached a
+// group total.
+class EncodedRows {
+public:
+    // Code of a column the row is too short to have
+    static constexpr uint32_t kMissing = StringPool::npos;
+
+    // With missing_as_empty, a column past the end of a short row reads as
+    // an empty cell instead of kMissing
+    EncodedRows(const DataFrame& df, size_t result_column, const std::vector<int>& columns, bool missing_as_empty = false)
+        : width(columns.size() + 1), pools(columns.size()), value_ints(columns.size()) {
+        for (const Row& row : df) {
+            if (row.size() < 8 || result_column >= row.size()) continue;
+            Outcome outcome = classifyOutcome(row[result_column]);
+            if (outcome == Outcome::Other) continue;
+            outcomes.push_back(outcome);
+            codes.push_back(players.intern(row[0]));
+            for (size_t c = 0; c < columns.size(); ++c) {
+                size_t column = static_cast<size_t>(columns[c]);
+                if (column < row.size()) codes.push_back(pools[c].intern(row[column]));
+                else codes.push_back(missing_as_empty ? pools[c].intern("") : kMissing);
+            }
+        }
+        for (size_t c = 0; c < columns.size(); ++c) {
+            value_ints[c].reserve(pools[c].size());
+            for (uint32_t code = 0; code < pools[c].size(); ++code) value_ints[c].push_back(parseIntOr(pools[c].str(code), 0));
+        }
+        player_ranks = joinedRanks(players);
+        for (const StringPool& pool : pools) value_ranks.push_back(joinedRanks(pool));
+    }
+
+    size_t size() const { return outcomes.size(); }
+
+    // The player's code followed by one code per column
+    const uint32_t* row(size_t r) const { return codes.data() + r * width; }
+    Outcome outcome(size_t r) const { return outcomes[r]; }
+
+    size_t playerCount() const { return players.size(); }
+    size_t valueCount(size_t column) const { return pools[column].size(); }
+
+    const std::string& player(uint32_t code) const { return players.str(code); }
+    const std::string& value(size_t column, uint32_t code) const { return pools[column].str(code); }
+    int valueInt(size_t column, uint32_t code) const { return value_ints[column][code]; }
+
+    // False when some player or value holds a '|'; keyRank() is then not
+    // usable and keys must be compared as strings
+    bool separatorFree() const { return separator_free; }
+
+    // Position of a value among its column's values as the string keys
+    // "player|value|..." ordered them, followed by '|' or, when last, by
+    // the end of the key. Comparing keys rank by rank gives the string
+    // order without building strings. column == npos for the player.
+    uint32_t keyRank(size_t column, uint32_t code, bool last) const {
+        const std::vector<uint32_t>& ranks = column == npos ? player_ranks : value_ranks[column];
+        return ranks[2 * size_t(code) + (last ? 0 : 1)];
+    }
+
+    // Bits a keyRank() of the column takes
+    unsigned rankBits(size_t column) const {
+        size_t ranks = 2 * (column == npos ? players.size() : pools[column].size());
+        unsigned bits = 0;
+        while (bits < 64 && ranks > (size_t(1) << bits)) bits++;
+        return bits;
+    }
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+    // Ranks of every (string, followed by end or '|') of a pool
+    std::vector<uint32_t> joinedRanks(const StringPool& pool) {
+        std::vector<uint32_t> items(2 * pool.size());
+        for (uint32_t i = 0; i < items.size(); ++i) items[i] = i;
+        for (uint32_t code = 0; code < pool.size(); ++code) {
+            if (pool.str(code).find('|') != std::string::npos) separator_free = false;
+        }
+        // String, then the end (-1) or '|' after it, compared bytewise
+        std::sort(items.begin(), items.end(), [&](uint32_t a, uint32_t b) {
+            std::string_view sa = pool.str(a / 2), sb = pool.str(b / 2);
+            size_t n = std::min(sa.size(), sb.size());
+            int cmp = sa.compare(0, n, sb, 0, n);
+            if (cmp != 0) return cmp < 0;
+            int ca = sa.size() > n ? static_cast<unsigned char>(sa[n]) : (a % 2 ? '|' : -1);
+            int cb = sb.size() > n ? static_cast<unsigned char>(sb[n]) : (b % 2 ? '|' : -1);
+            return ca < cb;
+        });
+        std::vector<uint32_t> ranks(items.size());
+        for (uint32_t i = 0; i < items.size(); ++i) ranks[items[i]] = i;
+        return ranks;
+    }
+
+    size_t width;
+    std::vector<uint32_t> codes;
+    std::vector<Outcome> outcomes;
+    StringPool players;
+    std::vector<StringPool> pools;
+    std::vector<std::vector<int>> value_ints;
+    std::vector<uint32_t> player_ranks;
+    std::vector<std::vector<uint32_t>> value_ranks;
+    bool separator_free = true;
+};
+
+// Most columns one combination groups by
+constexpr size_t kMaxColumns = 16;
+
+// A counted group decoded for output: the player code, then the value
+// codes of the combination's columns
+struct GroupKey {
+    std::array<uint32_t, kMaxColumns + 1> codes{};
+};
+
+struct GroupCounts {
+    int over = 0;
+    int under = 0;
+};
+
+struct CountedGroup {
+    GroupKey key;
+    GroupCounts counts;
+};
+
+// Orders two groups as their "player|value|value..." strings compare, the
+// order the string-keyed maps used to write them in. Columns coded
+// kMissing are not part of the string; terminated adds the '|' some tools
+// put after the last value too.
+inline bool joinedLess(const EncodedRows& rows, const std::vector<size_t>& columns,
+                       const GroupKey& a, const GroupKey& b, bool terminated) {
+    using Segments = std::array<std::string_view, kMaxColumns + 1>;
+    auto segments = [&](const GroupKey& key, Segments& out) {
+        size_t n = 0;
+        out[n++] = rows.player(key.codes[0]);
+        for (size_t i = 0; i < columns.size() && key.codes[i + 1] != EncodedRows::kMissing; ++i) {
+            out[n++] = rows.value(columns[i], key.codes[i + 1]);
+        }
+        return n;
+    };
+    Segments sa, sb;
+    size_t na = segments(a, sa), nb = segments(b, sb);
+
+    // Equal leading segments add the same characters to both strings
+    size_t first = 0;
+    while (first < na && first < nb && sa[first] == sb[first]) ++first;
+    if (first == na || first == nb) return na < nb;
+
+    // Walk both strings from the first differing segment, '|' between segments
+    size_t ia = first, ib = first, pa = 0, pb = 0;
+    auto next = [terminated](const Segments& s, size_t n, size_t& i, size_t& p) -> int {
+        if (i >= n) return -1;
+        if (p < s[i].size()) return static_cast<unsigned char>(s[i][p++]);
+        ++i;
+        p = 0;
+        return i < n || terminated ? '|' : -1;
+    };
+    while (true) {
+        int ca = next(sa, na, ia, pa), cb = next(sb, nb, ib, pb);
+        if (ca != cb) return ca < cb;
+        if (ca < 0) return false;
+    }
+}
+
+// Sorts one combination's groups into the order of their string keys
+inline void sortJoined(const EncodedRows& rows, const std::vector<size_t>& columns,
+                       std::vector<CountedGroup>& groups, bool terminated) {
+    if (!rows.separatorFree()) {
+        std::sort(groups.begin(), groups.end(), [&](const CountedGroup& a, const CountedGroup& b) {
+            return joinedLess(rows, columns, a.key, b.key, terminated);
+        });
+        return;
+    }
+    // Two keys differ in rank at their first differing segment, so the
+    // rank sequences never tie short of the same key, and one that ends
+    // early can be padded with zeros
+    auto segment_length = [&](const GroupKey& key) {
+        uint32_t length = 1;
+        while (length <= columns.size() && key.codes[length] != EncodedRows::kMissing) length++;
+        return length;
+    };
+    auto rank_of = [&](const GroupKey& key, uint32_t i, uint32_t length) {
+        bool last = i + 1 == length && !terminated;
+        return rows.keyRank(i == 0 ? EncodedRows::npos : columns[i - 1], key.codes[i], last);
+    };
+
+    // Ranks packed high to low into one integer when they fit
+    std::vector<unsigned> shifts;
+    unsigned used = 0;
+    for (size_t i = 0; i <= columns.size() && used <= 64; ++i) {
+        used += rows.rankBits(i == 0 ? EncodedRows::npos : columns[i - 1]);
+        shifts.push_back(64 - std::min(used, 64u));
+    }
+    if (used <= 64) {
+        std::vector<std::pair<uint64_t, uint32_t>> packed(groups.size());
+        for (size_t g = 0; g < groups.size(); ++g) {
+            const GroupKey& key = groups[g].key;
+            uint32_t length = segment_length(key);
+            uint64_t value = 0;
+            for (uint32_t i = 0; i < length; ++i) value |= uint64_t(rank_of(key, i, length)) << shifts[i];
+            packed[g] = { value, static_cast<uint32_t>(g) };
+        }
+        std::sort(packed.begin(), packed.end());
+        std::vector<CountedGroup> sorted;
+        sorted.reserve(groups.size());
+        for (const auto& item : packed) sorted.push_back(groups[item.second]);
+        groups.swap(sorted);
+        return;
+    }
+
+    struct Ranked {
+        std::array<uint32_t, kMaxColumns + 1> ranks;
+        uint32_t length;
+        uint32_t index;
+    };
+    std::vector<Ranked> ranked(groups.size());
+    for (size_t g = 0; g < groups.size(); ++g) {
+        const GroupKey& key = groups[g].key;
+        Ranked& item = ranked[g];
+        item.length = segment_length(key);
+        item.index = static_cast<uint32_t>(g);
+        for (uint32_t i = 0; i < item.length; ++i) item.ranks[i] = rank_of(key, i, item.length);
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const Ranked& a, const Ranked& b) {
+        return std::lexicographical_compare(a.ranks.begin(), a.ranks.begin() + a.length,
+                                            b.ranks.begin(), b.ranks.begin() + b.length);
+    });
+    std::vector<CountedGroup> sorted;
+    sorted.reserve(groups.size());
+    for (const Ranked& item : ranked) sorted.push_back(groups[item.index]);
+    groups.swap(sorted);
+}
+
+// Which rows reached a minimum support, per combination of one set size:
+// a row is set for a combination when its group there has at least
+// min_support rows. Bits are laid out combination by combination, so
+// counting different combinations never writes the same word.
+class RowSupport {
+public:
+    RowSupport(size_t rows, size_t combinations) : stride((rows + 63) / 64), bits(stride * combinations, 0) {}
+
+    void set(size_t combination, size_t row) { bits[combination * stride + row / 64] |= uint64_t(1) << (row % 64); }
+    bool test(size_t combination, size_t row) const { return (bits[combination * stride + row / 64] >> (row % 64)) & 1; }
+
+private:
+    size_t stride;
+    std::vector<uint64_t> bits;
+};
+
+// Minimum-support pruning (Apriori) for one set size. A group has no more
+// rows than the group of any subset of its columns, so once a row's group
+// over some k-1 columns falls below min_support, every group of k columns
+// the row adds to falls below it too. Such rows are skipped, and groups
+// below min_support are dropped from the result.
+struct SupportPruning {
+    int min_support = 0;
+
+    // Rows that reached min_support one set size down, and per combination
+    // the indices there of its subsets one column short; none for the
+    // smallest set size counted
+    const RowSupport* below = nullptr;
+    std::vector<std::vector<size_t>> subsets;
+
+    // Filled with the rows that reached min_support at this set size, for
+    // the next one up; none for the largest
+    RowSupport* reached = nullptr;
+};
+
+// Per combination given as a bit mask of its items, the indices of the
+// combinations one item short among lower_masks
+inline std::vector<std::vector<size_t>> subsetIndices(const std::vector<uint32_t>& masks, const std::vector<uint32_t>& lower_masks) {
+    std::vector<std::vector<size_t>> subsets;
+    for (uint32_t mask : masks) {
+        std::vector<size_t> indices;
+        for (uint32_t rest = mask; rest != 0; rest &= rest - 1) {
+            uint32_t subset = mask & ~(rest & (0u - rest));
+            auto it = std::find(lower_masks.begin(), lower_masks.end(), subset);
+            if (it != lower_masks.end()) indices.push_back(static_cast<size_t>(it - lower_masks.begin()));
+        }
+        subsets.push_back(std::move(indices));
+    }
+    return subsets;
+}
+
+// Counts the groups of many column combinations over one file's encoded
+// rows. Combinations are taken a batch at a time: one pass over the rows
+// updates the counters of every combination in the batch, so the rows are
+// read once per batch instead of once per combination.
+//
+// A group is keyed by its codes packed into one or two 64-bit words (a
+// wider key only when the columns have that many distinct values) in a
+// flat hash map, and decoded again for output.
+class CombinationCounter {
+public:
+    static constexpr size_t kBatchSize = 16;
+
+    // Entries reserved per map before counting; larger maps grow as needed
+    static constexpr size_t kMaxReserve = size_t(1) << 14;
+
+    // combinations holds, per combination, the positions of its columns in
+    // the columns the rows were encoded with; terminated is passed on to
+    // sortJoined for the output order
+    CombinationCounter(const EncodedRows& rows, const std::vector<std::vector<size_t>>& combinations, bool terminated = false)
+        : rows(rows), combinations(combinations), terminated(terminated) {}
+
+    size_t size() const { return combinations.size(); }
+
+    // Counts with minimum-support pruning from now on; rollUp() needs the
+    // full groups and must not be used with it
+    void prune(const SupportPruning* support) { pruning = support; }
+
+    // Groups of combinations [first, last) with an over or under result,
+    // each combination's in output order
+    std::vector<std::vector<CountedGroup>> countBatch(size_t first, size_t last) const {
+        std::vector<size_t> batch;
+        for (size_t c = first; c < last; ++c) batch.push_back(c);
+        return countBatch(batch);
+    }
+
+    // Groups of the given combinations, counted in one pass over the rows
+    std::vector<std::vector<CountedGroup>> countBatch(const std::vector<size_t>& batch) const {
+        std::vector<KeyLayout> layouts;
+        size_t words = 1;
+        for (size_t c : batch) {
+            layouts.push_back(layoutOf(c));
+            words = std::max(words, layouts.back().words());
+        }
+        if (words == 1) return countWith<1>(batch, layouts);
+        if (words == 2) return countWith<2>(batch, layouts);
+        return countWith<kMaxColumns + 1>(batch, layouts);
+    }
+
+    // Groups of a combination summed from the groups of a parent
+    // combination with the same columns and more: a parent group adds to
+    // the group of its codes for the combination's columns, so the result
+    // equals counting the rows again, in fewer steps when the parent has
+    // fewer groups than there are rows
+    std::vector<CountedGroup> rollUp(size_t combination, const std::vector<size_t>& parent_columns,
+                                     const std::vector<CountedGroup>& parent_groups) const {
+        KeyLayout layout = layoutOf(combination);
+        if (layout.words() == 1) return rollUpWith<1>(combination, layout, parent_columns, parent_groups);
+        if (layout.words() == 2) return rollUpWith<2>(combination, layout, parent_columns, parent_groups);
+        return rollUpWith<kMaxColumns + 1>(combination, layout, parent_columns, parent_groups);
+    }
+
+private:
+    template <size_t Words>
+    using GroupMap = FlatHashMap<PackedKey<Words>, GroupCounts, PackedKeyHash>;
+
+    // A missing column packs as one past the column's last code
+    KeyLayout layoutOf(size_t combination) const {
+        std::vector<uint64_t> max_values{ rows.playerCount() };
+        for (size_t column : combinations[combination]) max_values.push_back(rows.valueCount(column));
+        return KeyLayout(max_values);
+    }
+
+    // No more groups than rows, or than the columns' value combinations
+    size_t reserveFor(size_t combination) const {
+        size_t bound = std::max<size_t>(rows.playerCount(), 1);
+        for (size_t column : combinations[combination]) {
+            if (bound >= kMaxReserve) break;
+            bound *= rows.valueCount(column) + 1;
+        }
+        return std::min({ bound, rows.size(), kMaxReserve });
+    }
+
+    template <size_t Words>
+    std::vector<std::vector<CountedGroup>> countWith(const std::vector<size_t>& batch, const std::vector<KeyLayout>& layouts) const {
+        using Key = PackedKey<Words>;
+        size_t count = batch.size();
+
+        std::vector<GroupMap<Words>> maps;
+        maps.reserve(count);
+        for (size_t c : batch) maps.emplace_back(reserveFor(c));
+
+        auto key_of = [&](size_t r, size_t c) {
+            const uint32_t* codes = rows.row(r);
+            const std::vector<size_t>& columns = combinations[batch[c]];
+            const KeyLayout& layout = layouts[c];
+            Key key;
+            layout.set(key, 0, codes[0]);
+            for (size_t i = 0; i < columns.size(); ++i) {
+                uint32_t code = codes[columns[i] + 1];
+                layout.set(key, i + 1, code == EncodedRows::kMissing ? rows.valueCount(columns[i]) : code);
+            }
+            return key;
+        };
+        // A row counts unless a subset one column short left it below support
+        auto counted = [&](size_t r, size_t c) {
+            if (!pruning || !pruning->below) return true;
+            for (size_t subset : pruning->subsets[batch[c]]) {
+                if (!pruning->below->test(subset, r)) return false;
+            }
+            return true;
+        };
+
+        for (size_t r = 0; r < rows.size(); ++r) {
+            bool over = rows.outcome(r) == Outcome::Over;
+            for (size_t c = 0; c < count; ++c) {
+                if (!counted(r, c)) continue;
+                GroupCounts& counts = maps[c][key_of(r, c)];
+                if (over) counts.over++;
+                else counts.under++;
+            }
+        }
+
+        if (pruning && pruning->reached) {
+            for (size_t r = 0; r < rows.size(); ++r) {
+                for (size_t c = 0; c < count; ++c) {
+                    if (!counted(r, c)) continue;
+                    const GroupCounts* counts = maps[c].find(key_of(r, c));
+                    if (counts->over + counts->under >= pruning->min_support) pruning->reached->set(batch[c], r);
+                }
+            }
+        }
+
+        std::vector<std::vector<CountedGroup>> groups(count);
+        for (size_t c = 0; c < count; ++c) groups[c] = decode(batch[c], layouts[c], maps[c]);
+        return groups;
+    }
+
+    template <size_t Words>
+    std::vector<CountedGroup> rollUpWith(size_t combination, const KeyLayout& layout, const std::vector<size_t>& parent_columns,
+                                         const std::vector<CountedGroup>& parent_groups) const {
+        using Key = PackedKey<Words>;
+        const std::vector<size_t>& columns = combinations[combination];
+
+        // Where each column sits in the parent's key
+        std::vector<size_t> from;
+        for (size_t column : columns) {
+            from.push_back(static_cast<size_t>(std::find(parent_columns.begin(), parent_columns.end(), column) - parent_columns.begin()) + 1);
+        }
+
+        GroupMap<Words> map(std::min(reserveFor(combination), parent_groups.size()));
+        for (const CountedGroup& parent : parent_groups) {
+            Key key;
+            layout.set(key, 0, parent.key.codes[0]);
+            for (size_t i = 0; i < columns.size(); ++i) {
+                uint32_t code = parent.key.codes[from[i]];
+                layout.set(key, i + 1, code == EncodedRows::kMissing ? rows.valueCount(columns[i]) : code);
+            }
+            GroupCounts& counts = map[key];
+            counts.over += parent.counts.over;
+            counts.under += parent.counts.under;
+        }
+        return decode(combination, layout, map);
+    }
+
+    // The groups of a combination's map, in output order
+    template <size_t Words>
+    std::vector<CountedGroup> decode(size_t combination, const KeyLayout& layout, const GroupMap<Words>& map) const {
+        const std::vector<size_t>& columns = combinations[combination];
+        std::vector<CountedGroup> groups;
+        groups.reserve(map.size());
+        int min_support = pruning ? pruning->min_support : 0;
+        map.forEach([&](const PackedKey<Words>& key, const GroupCounts& counts) {
+            if (counts.over + counts.under < min_support) return;
+            CountedGroup group;
+            group.key.codes[0] = static_cast<uint32_t>(layout.get(key, 0));
+            for (size_t i = 0; i < columns.size(); ++i) {
+                uint64_t code = layout.get(key, i + 1);
+                group.key.codes[i + 1] = code == rows.valueCount(columns[i]) ? EncodedRows::kMissing : static_cast<uint32_t>(code);
+            }
+            group.counts = counts;
+            groups.push_back(group);
+        });
+        sortJoined(rows, columns, groups, terminated);
+        return groups;
+    }
+
+    const EncodedRows& rows;
+    const std::vector<std::vector<size_t>>& combinations;
+    bool terminated;
+    const SupportPruning* pruning = nullptr;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "progress.h"
+
+#ifdef _WIN32
+#include <io.h>
+#define CONSOLE_PROGRESS_ISATTY(f) _isatty(_fileno(f))
+#else
+#include <unistd.h>
+#define CONSOLE_PROGRESS_ISATTY(f) isatty(fileno(f))
+#endif
+
+// Console counterpart of the GUI progress timers: a thread polls a
+// Progress and prints the formatted line to stderr. On a terminal the line
+// is redrawn in place; redirected (cron, logs) a new line is printed only
+// every log_interval, so logs stay short. Stops when destroyed.
+class ConsoleProgress {
+public:
+    using Format = std::function<std::string(const Progress::Snapshot&)>;
+
+    ConsoleProgress(const Progress& progress, Format format, bool enabled = true,
+        std::chrono::milliseconds log_interval = std::chrono::seconds(10))
+        : progress(progress), format(std::move(format)), terminal(CONSOLE_PROGRESS_ISATTY(stderr) != 0),
+          interval(terminal ? std::chrono::milliseconds(200) : log_interval) {
+        if (enabled) poller = std::thread([this] { run(); });
+    }
+
+    ConsoleProgress(const ConsoleProgress&) = delete;
+    ConsoleProgress& operator=(const ConsoleProgress&) = delete;
+
+    ~ConsoleProgress() { stop(); }
+
+    // Prints nothing more; call before printing the run's result
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        if (poller.joinable()) poller.join();
+    }
+
+private:
+    void run() {
+        std::string last;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!wake.wait_for(lock, interval, [this] { return stopping; })) {
+            Progress::Snapshot shot = progress.snapshot();
+            if (shot.finished) continue;
+            std::string line = format(shot);
+            if (line.empty() || line == last) continue;
+            if (terminal) {
+                // Pad over the rest of a longer previous line
+                std::string padded = line;
+                if (padded.size() < last.size()) padded.append(last.size() - padded.size(), ' ');
+                std::fprintf(stderr, "\r%s", padded.c_str());
+            }
+            else {
+                std::fprintf(stderr, "%s\n", line.c_str());
+            }
+            std::fflush(stderr);
+            last = std::move(line);
+        }
+        if (terminal && !last.empty()) {
+            std::fprintf(stderr, "\r%s\r", std::string(last.size(), ' ').c_str());
+            std::fflush(stderr);
+        }
+    }
+
+    const Progress& progress;
+    Format format;
+    bool terminal;
+    std::chrono::milliseconds interval;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread poller;
+};
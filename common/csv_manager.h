@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include "column_projection.h"
+#include "csv_reader.h"
+#include "csv_writer.h"
+#include "data_frame.h"
+#include "typed_cell.h"
+
+#ifndef CSV_MANAGER_NO_XLSX
+#include <xlnt/xlnt.hpp>
+#include "xlsx_reader.h"
+#include "xlsx_writer.h"
+#endif
+
+// CSV and XLSX I/O shared by the tools. Cells are UTF-8 std::string end to
+// end: CSV files are read and written as bytes (CsvReader / CsvWriter), and
+// only file paths and UI text are converted to and from wide strings.
+//
+// read() can take a ColumnProjection so unused columns are never materialized.
+// readTyped() returns integer cells as int32 instead of text.
+//
+// Define CSV_MANAGER_NO_XLSX to build without xlnt; .xlsx files then throw.
+class CSVManager {
+public:
+    static DataFrame read(const std::filesystem::path& filename, const ColumnProjection& projection = {}) {
+        std::string ext = getExtension(filename);
+        if (ext == ".csv") {
+            return readCSVFile(filename, projection);
+        }
+        else if (ext == ".xlsx" || ext == ".xls") {
+            return readXLSXFile(filename, projection);
+        }
+        else {
+            throw std::runtime_error("Unsupported file type");
+        }
+    }
+
+    static TypedFrame readTyped(const std::filesystem::path& filename, const ColumnProjection& projection = {}) {
+        std::string ext = getExtension(filename);
+        if (ext == ".csv") {
+            TypedFrame data;
+            CsvReader(filename, projection).forEachRow([&](const std::vector<std::string_view>& cells) {
+                TypedRow& row = data.emplace_back();
+                row.reserve(cells.size());
+                for (std::string_view cell : cells) row.push_back(TypedCell::fromText(cell));
+            });
+            return data;
+        }
+        else if (ext == ".xlsx" || ext == ".xls") {
+            return readTypedXLSXFile(filename, projection);
+        }
+        else {
+            throw std::runtime_error("Unsupported file type");
+        }
+    }
+
+    // Typed rows back to text, for writing
+    static DataFrame toDataFrame(const TypedFrame& typed) {
+        DataFrame data;
+        data.reserve(typed.size());
+        for (const TypedRow& typed_row : typed) {
+            Row& row = data.emplace_back();
+            row.reserve(typed_row.size());
+            for (const TypedCell& cell : typed_row) row.push_back(cell.toString());
+        }
+        return data;
+    }
+
+    static void write(const DataFrame& data, const std::filesystem::path& filename) {
+        std::string ext = getExtension(filename);
+        if (ext == ".csv") {
+            writeCSVFile(data, filename);
+        }
+        else if (ext == ".xlsx" || ext == ".xls") {
+            writeXLSXFile(data, filename);
+        }
+        else {
+            throw std::runtime_error("Unsupported file type");
+        }
+    }
+
+    // UTF-16 (Windows) or UTF-32 wide text <-> UTF-8, for paths and UI only
+    static std::string ws2s(const std::wstring& wstr) {
+        return std::filesystem::path(wstr).u8string();
+    }
+
+    static std::wstring s2ws(const std::string& str) {
+        return std::filesystem::u8path(str).wstring();
+    }
+
+private:
+    static std::string getExtension(const std::filesystem::path& filename) {
+        std::string ext = filename.extension().u8string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return ext;
+    }
+
+    static DataFrame readCSVFile(const std::filesystem::path& filename, const ColumnProjection& projection) {
+        return CsvReader::read(filename, projection);
+    }
+
+    static void writeCSVFile(const DataFrame& data, const std::filesystem::path& filename) {
+        CsvWriter::write(data, filename);
+    }
+
+#ifndef CSV_MANAGER_NO_XLSX
+    static DataFrame readXLSXFile(const std::filesystem::path& filename, const ColumnProjection& projection) {
+        return XlsxReader::read(filename, projection);
+    }
+
+    static TypedFrame readTypedXLSXFile(const std::filesystem::path& filename, const ColumnProjection& projection) {
+        return XlsxReader::readTyped(filename, projection);
+    }
+
+    static void writeXLSXFile(const DataFrame& data, const std::filesystem::path& filename) {
+        XlsxWriter::write(data, filename);
+    }
+#else
+    static DataFrame readXLSXFile(const std::filesystem::path&, const ColumnProjection&) {
+        throw std::runtime_error("XLSX support is not built in");
+    }
+
+    static TypedFrame readTypedXLSXFile(const std::filesystem::path&, const ColumnProjection&) {
+        throw std::runtime_error("XLSX support is not built in");
+    }
+
+    static void writeXLSXFile(const DataFrame&, const std::filesystem::path&) {
+        throw std::runtime_error("XLSX support is not built in");
+    }
+#endif
+};
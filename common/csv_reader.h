@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "column_projection.h"
+#include "csv_scan.h"
+#include "data_frame.h"
+#include "mapped_file.h"
+
+// Memory-mapped CSV reader (RFC 4180). Records end at \n, \r\n or \r outside
+// quotes; quoted fields may hold commas, line breaks and doubled quotes.
+// Unquoted fields are trimmed of spaces and tabs like the old getline
+// readers did. Empty lines are skipped and a UTF-8 BOM is ignored.
+//
+// Field boundaries come from CsvStructuralScanner's block masks; the kernel
+// (scalar, SSE2 or AVX2) is picked at runtime unless one is passed in.
+//
+// forEachRow hands out string_views into the mapping. Only quoted fields
+// with doubled quotes are unescaped, into a per-row buffer; all views are
+// valid until the callback returns. Fields outside the projection are
+// skipped without unescaping and come out empty.
+class CsvReader {
+public:
+    explicit CsvReader(const std::filesystem::path& path, const CsvScanKernel& kernel = bestCsvKernel())
+        : CsvReader(path, ColumnProjection(), kernel) {}
+
+    CsvReader(const std::filesystem::path& path, ColumnProjection projection, const CsvScanKernel& kernel = bestCsvKernel())
+        : kernel(kernel), projection(std::move(projection)) {
+        if (!file.open(path)) {
+            throw std::runtime_error("Cannot open file: " + path.u8string());
+        }
+    }
+
+    template <typename OnRow>
+    void forEachRow(OnRow&& on_row) const {
+        const char* p = file.data();
+        const char* end = p + file.size();
+        if (end - p >= 3 && std::memcmp(p, "\xEF\xBB\xBF", 3) == 0) p += 3;
+        CsvStructuralScanner scanner(p, end, kernel.classify);
+
+        std::vector<std::string_view> cells;
+        std::vector<Unescaped> unescaped;
+        std::string scratch;
+        while (p < end) {
+            if (*p == '\n' || *p == '\r') {
+                p = skipNewline(p, end);
+                continue;
+            }
+            cells.clear();
+            unescaped.clear();
+            scratch.clear();
+            for (;;) {
+                if (projection.contains(cells.size())) {
+                    p = parseField(p, end, scanner, cells, unescaped, scratch);
+                }
+                else {
+                    p = skipField(p, end, scanner);
+                    cells.emplace_back();
+                }
+                if (p < end && *p == ',') {
+                    ++p;
+                    continue;
+                }
+                p = skipNewline(p, end);
+                break;
+            }
+
+            // Views into scratch are resolved last, once it stops growing
+            for (const Unescaped& field : unescaped) {
+                cells[field.cell] = std::string_view(scratch.data() + field.offset, cells[field.cell].size());
+            }
+            on_row(cells);
+        }
+    }
+
+    // Copies every record into an owning DataFrame
+    DataFrame readAll() const {
+        DataFrame data;
+        forEachRow([&](const std::vector<std::string_view>& cells) {
+            data.emplace_back(cells.begin(), cells.end());
+        });
+        return data;
+    }
+
+    static DataFrame read(const std::filesystem::path& path, const ColumnProjection& projection = {}) {
+        return CsvReader(path, projection).readAll();
+    }
+
+private:
+    // A cell whose text lives in the row's scratch buffer
+    struct Unescaped {
+        size_t cell;
+        size_t offset;
+    };
+
+    static bool isBlank(char c) { return c == ' ' || c == '\t'; }
+
+    static const char* skipNewline(const char* p, const char* end) {
+        if (p < end && *p == '\r') ++p;
+        if (p < end && *p == '\n') ++p;
+        return p;
+    }
+
+    // Parses one field starting at p and returns the position of the ',',
+    // line break or end of input that follows it.
+    static const char* parseField(const char* p, const char* end, CsvStructuralScanner& scanner,
+        std::vector<std::string_view>& cells, std::vector<Unescaped>& unescaped, std::string& scratch) {
+        constexpr unsigned kFieldEnd = CsvStructuralScanner::kComma | CsvStructuralScanner::kNewline;
+        const char* start = p;
+        while (p < end && isBlank(*p)) ++p;
+
+        if (p == end || *p != '"') {
+            p = scanner.next(p, kFieldEnd);
+            const char* first = start;
+            const char* last = p;
+            while (first < last && isBlank(*first)) ++first;
+            while (last > first && isBlank(last[-1])) --last;
+            cells.emplace_back(first, static_cast<size_t>(last - first));
+            return p;
+        }
+
+        // Quoted: the common case has no doubled quotes and stays a view
+        const char* content = ++p;
+        size_t scratch_start = scratch.size();
+        bool escaped = false;
+        for (;;) {
+            const char* quote = scanner.next(p, CsvStructuralScanner::kQuote);
+            if (quote == end) {
+                // Unterminated quote runs to end of input
+                if (escaped) scratch.append(p, end);
+                p = end;
+                break;
+            }
+            if (quote + 1 < end && quote[1] == '"') {
+                scratch.append(escaped ? p : content, quote + 1);
+                escaped = true;
+                p = quote + 2;
+                continue;
+            }
+            if (escaped) scratch.append(p, quote);
+            const char* content_end = quote;
+            p = quote + 1;
+
+            // Anything between the closing quote and the delimiter is kept
+            const char* tail = p;
+            p = scanner.next(p, kFieldEnd);
+            const char* tail_end = p;
+            while (tail_end > tail && isBlank(tail_end[-1])) --tail_end;
+            if (tail != tail_end) {
+                if (!escaped) scratch.append(content, content_end);
+                scratch.append(tail, tail_end);
+                escaped = true;
+            }
+            if (!escaped) {
+                cells.emplace_back(content, static_cast<size_t>(content_end - content));
+                return p;
+            }
+            break;
+        }
+        if (!escaped) {
+            cells.emplace_back(content, static_cast<size_t>(p - content));
+        }
+        else {
+            unescaped.push_back({ cells.size(), scratch_start });
+            cells.emplace_back(nullptr, scratch.size() - scratch_start);
+        }
+        return p;
+    }
+
+    // Steps over one field like parseField without producing a cell
+    static const char* skipField(const char* p, const char* end, CsvStructuralScanner& scanner) {
+        while (p < end && isBlank(*p)) ++p;
+        if (p < end && *p == '"') {
+            ++p;
+            for (;;) {
+                const char* quote = scanner.next(p, CsvStructuralScanner::kQuote);
+                if (quote == end) return end;
+                p = quote + 1;
+                if (p < end && *p == '"') {
+                    ++p;
+                    continue;
+                }
+                break;
+            }
+        }
+        return scanner.next(p, CsvStructuralScanner::kComma | CsvStructuralScanner::kNewline);
+    }
+
+    MappedFile file;
+    CsvScanKernel kernel;
+    ColumnProjection projection;
+};
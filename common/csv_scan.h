@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CSV_SCAN_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Stage one of the CSV reader: classifies 64 input bytes at a time into
+// bitmasks of delimiters, quotes and line breaks (bit i = byte i), in the
+// style of simdjson. The reader takes field boundaries from these masks
+// instead of testing every byte.
+struct CsvBlockMasks {
+    uint64_t comma;
+    uint64_t quote;
+    uint64_t newline; // \n or \r
+};
+
+// Classifies exactly 64 readable bytes
+using CsvClassifyFn = CsvBlockMasks (*)(const char* block);
+
+struct CsvScanKernel {
+    const char* name;
+    CsvClassifyFn classify;
+};
+
+inline CsvBlockMasks classifyCsvScalar(const char* block) {
+    CsvBlockMasks masks{ 0, 0, 0 };
+    for (int i = 0; i < 64; ++i) {
+        uint64_t bit = uint64_t(1) << i;
+        char c = block[i];
+        masks.comma |= c == ',' ? bit : 0;
+        masks.quote |= c == '"' ? bit : 0;
+        masks.newline |= (c == '\n' || c == '\r') ? bit : 0;
+    }
+    return masks;
+}
+
+#ifdef CSV_SCAN_X86
+inline CsvBlockMasks classifyCsvSse2(const char* block) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    CsvBlockMasks masks{ 0, 0, 0 };
+    for (int i = 0; i < 4; ++i) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+        int shift = i * 16;
+        masks.comma |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, comma)))) << shift;
+        masks.quote |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)))) << shift;
+        masks.newline |= uint64_t(uint16_t(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr))))) << shift;
+    }
+    return masks;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx2")))
+#endif
+inline CsvBlockMasks classifyCsvAvx2(const char* block) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    CsvBlockMasks masks{ 0, 0, 0 };
+    for (int i = 0; i < 2; ++i) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i * 32));
+        int shift = i * 32;
+        masks.comma |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, comma)))) << shift;
+        masks.quote |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)))) << shift;
+        masks.newline |= uint64_t(uint32_t(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, lf), _mm256_cmpeq_epi8(v, cr))))) << shift;
+    }
+    return masks;
+}
+
+// AVX2 needs both the CPU feature and OS support for the YMM state
+inline bool cpuHasAvx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool os_avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    return os_avx && (info[1] & (1 << 5));
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+// Kernels this CPU can run, slowest first
+inline std::vector<CsvScanKernel> availableCsvKernels() {
+    std::vector<CsvScanKernel> kernels{ { "scalar", classifyCsvScalar } };
+#ifdef CSV_SCAN_X86
+    kernels.push_back({ "sse2", classifyCsvSse2 });
+    if (cpuHasAvx2()) kernels.push_back({ "avx2", classifyCsvAvx2 });
+#endif
+    return kernels;
+}
+
+// Picked once per process
+inline const CsvScanKernel& bestCsvKernel() {
+    static const CsvScanKernel best = availableCsvKernels().back();
+    return best;
+}
+
+// Finds structural bytes in [begin, end) through the block masks. Blocks are
+// classified on demand, 64 bytes at a time; the last partial block is copied
+// into a zero-padded buffer first.
+class CsvStructuralScanner {
+public:
+    enum Kind : unsigned { kComma = 1, kQuote = 2, kNewline = 4 };
+
+    CsvStructuralScanner(const char* begin, const char* end, CsvClassifyFn classify)
+        : begin(begin), end(end), classify(classify) {
+        if (begin < end) load(begin);
+    }
+
+    // First byte at or after p whose kind is in kinds, or end
+    const char* next(const char* p, unsigned kinds) {
+        while (p < end) {
+            if (p - block_begin >= 64) load(p);
+            uint64_t mask = kinds == (kComma | kNewline) ? field_end
+                : ((kinds & kComma) ? masks.comma : 0) | ((kinds & kQuote) ? masks.quote : 0) |
+                  ((kinds & kNewline) ? masks.newline : 0);
+            mask >>= p - block_begin;
+            if (mask != 0) {
+                const char* hit = p + countTrailingZeros(mask);
+                return hit < end ? hit : end;
+            }
+            p = block_begin + 64;
+        }
+        return end;
+    }
+
+private:
+    static int countTrailingZeros(uint64_t mask) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return static_cast<int>(index);
+#elif defined(_MSC_VER)
+        unsigned long index;
+        if (_BitScanForward(&index, static_cast<uint32_t>(mask))) return static_cast<int>(index);
+        _BitScanForward(&index, static_cast<uint32_t>(mask >> 32));
+        return static_cast<int>(index) + 32;
+#else
+        return __builtin_ctzll(mask);
+#endif
+    }
+
+    // Classifies the 64-byte block holding p, p is never behind the current
+    // block. Blocks are aligned to begin.
+    void load(const char* p) {
+        block_begin = begin + static_cast<size_t>(p - begin) / 64 * 64;
+        if (end - block_begin >= 64) {
+            masks = classify(block_begin);
+        }
+        else {
+            char padded[64] = {};
+            std::memcpy(padded, block_begin, static_cast<size_t>(end - block_begin));
+            masks = classify(padded);
+        }
+        field_end = masks.comma | masks.newline;
+    }
+
+    const char* begin;
+    const char* end;
+    CsvClassifyFn classify;
+    const char* block_begin = nullptr;
+    CsvBlockMasks masks{ 0, 0, 0 };
+    uint64_t field_end = 0;
+};
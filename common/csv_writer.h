@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <fmt/format.h>
+#include "data_frame.h"
+
+// Buffered CSV writer. Fields are formatted with fmt into one reusable
+// memory buffer that goes to the file in blocks of kFlushBytes. A field is
+// quoted (RFC 4180, quotes doubled) only when it holds a comma, quote or
+// line break. Numbers are formatted straight into the buffer.
+//
+// Records end in \r\n on Windows and \n elsewhere, the bytes the old
+// text-mode streams produced.
+//
+// A writer made without a path formats into memory only: rows built on
+// other threads are taken from it and appended to the file's writer in
+// order.
+class CsvWriter {
+public:
+    static constexpr size_t kFlushBytes = size_t(1) << 20;
+
+    explicit CsvWriter(const std::filesystem::path& path) : file(path, std::ios::binary) {
+        if (!file.is_open()) {
+            throw std::runtime_error("Cannot create file: " + path.u8string());
+        }
+        buffer.reserve(kFlushBytes + 4096);
+    }
+
+    CsvWriter() = default;
+
+    CsvWriter(const CsvWriter&) = delete;
+    CsvWriter& operator=(const CsvWriter&) = delete;
+
+    // Flushes what is left; call close() to see write errors
+    ~CsvWriter() {
+        if (file.is_open()) {
+            flush();
+        }
+    }
+
+    CsvWriter& field(std::string_view text) {
+        separate();
+        if (!needsQuotes(text)) {
+            buffer.append(text.data(), text.data() + text.size());
+            return *this;
+        }
+        buffer.push_back('"');
+        for (char c : text) {
+            if (c == '"') buffer.push_back('"');
+            buffer.push_back(c);
+        }
+        buffer.push_back('"');
+        return *this;
+    }
+
+    template <typename Int, std::enable_if_t<std::is_integral_v<Int>, int> = 0>
+    CsvWriter& field(Int value) {
+        separate();
+        fmt::format_to(std::back_inserter(buffer), "{}", value);
+        return *this;
+    }
+
+    // Fixed notation, as std::fixed << std::setprecision(precision)
+    CsvWriter& field(double value, int precision) {
+        separate();
+        fmt::format_to(std::back_inserter(buffer), "{:.{}f}", value, precision);
+        return *this;
+    }
+
+    void endRow() {
+#ifdef _WIN32
+        static const char crlf[] = "\r\n";
+        buffer.append(crlf, crlf + 2);
+#else
+        buffer.push_back('\n');
+#endif
+        row_started = false;
+        if (buffer.size() >= kFlushBytes && file.is_open()) flush();
+    }
+
+    // The rows formatted in memory so far; the writer starts over empty
+    std::string take() {
+        std::string bytes(buffer.data(), buffer.size());
+        buffer.clear();
+        return bytes;
+    }
+
+    // Rows another writer formatted, at a row boundary; a large block goes
+    // to the file as it is, and a writer without a file keeps it all
+    void append(std::string_view bytes) {
+        if (!file.is_open() || buffer.size() + bytes.size() < kFlushBytes) {
+            buffer.append(bytes.data(), bytes.data() + bytes.size());
+            return;
+        }
+        flush();
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    // Cells may be any range of std::string or std::string_view
+    template <typename Cells>
+    void writeRow(const Cells& cells) {
+        for (const auto& cell : cells) field(std::string_view(cell));
+        endRow();
+    }
+
+    void close() {
+        flush();
+        file.close();
+        if (file.fail()) {
+            throw std::runtime_error("Cannot write CSV file");
+        }
+    }
+
+    static void write(const DataFrame& data, const std::filesystem::path& path) {
+        CsvWriter writer(path);
+        for (const Row& row : data) writer.writeRow(row);
+        writer.close();
+    }
+
+private:
+    static bool needsQuotes(std::string_view text) {
+        for (char c : text) {
+            if (c == ',' || c == '"' || c == '\r' || c == '\n') return true;
+        }
+        return false;
+    }
+
+    void separate() {
+        if (row_started) buffer.push_back(',');
+        row_started = true;
+    }
+
+    void flush() {
+        if (!file.is_open()) return;
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    std::ofstream file;
+    fmt::memory_buffer buffer;
+    bool row_started = false;
+};
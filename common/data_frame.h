@@ -0,0 +1,8 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// CSV/Excel-like data structure shared by the tools
+using Row = std::vector<std::string>;
+using DataFrame = std::vector<Row>;
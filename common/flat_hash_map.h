@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Open-addressing hash map for hot counting loops. Keys and values live in
+// one flat array probed linearly, so a lookup touches one or two cache
+// lines and never allocates once the table is large enough. The capacity
+// is a power of two kept at most 70% full; reserve() up front keeps
+// rehashing out of the loop. Entries are never erased.
+template <typename Key, typename Value, typename Hash>
+class FlatHashMap {
+public:
+    explicit FlatHashMap(size_t expected = 0) { reserve(expected); }
+
+    // Room for expected entries without rehashing
+    void reserve(size_t expected) {
+        size_t capacity = 16;
+        while (capacity * 7 < expected * 10) capacity *= 2;
+        if (capacity > slots.size()) rehash(capacity);
+    }
+
+    // The value of key, value-initialized if key is new
+    Value& operator[](const Key& key) {
+        if ((count + 1) * 10 > slots.size() * 7) rehash(std::max<size_t>(16, slots.size() * 2));
+        size_t mask = slots.size() - 1;
+        for (size_t i = hash(key) & mask;; i = (i + 1) & mask) {
+            Slot& slot = slots[i];
+            if (!slot.used) {
+                slot.used = true;
+                slot.key = key;
+                count++;
+                return slot.value;
+            }
+            if (slot.key == key) return slot.value;
+        }
+    }
+
+    // The value of key, or nullptr if key was never added
+    const Value* find(const Key& key) const {
+        if (slots.empty()) return nullptr;
+        size_t mask = slots.size() - 1;
+        for (size_t i = hash(key) & mask;; i = (i + 1) & mask) {
+            const Slot& slot = slots[i];
+            if (!slot.used) return nullptr;
+            if (slot.key == key) return &slot.value;
+        }
+    }
+
+    size_t size() const { return count; }
+
+    // Calls f(key, value) for every entry, in table order
+    template <typename F>
+    void forEach(F&& f) const {
+        for (const Slot& slot : slots) {
+            if (slot.used) f(slot.key, slot.value);
+        }
+    }
+
+private:
+    struct Slot {
+        Key key{};
+        Value value{};
+        bool used = false;
+    };
+
+    void rehash(size_t capacity) {
+        std::vector<Slot> old(capacity);
+        old.swap(slots);
+        size_t mask = capacity - 1;
+        for (Slot& slot : old) {
+            if (!slot.used) continue;
+            size_t i = hash(slot.key) & mask;
+            while (slots[i].used) i = (i + 1) & mask;
+            slots[i] = std::move(slot);
+        }
+    }
+
+    std::vector<Slot> slots;
+    size_t count = 0;
+    Hash hash;
+};
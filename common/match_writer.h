@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "csv_writer.h"
+#include "data_frame.h"
+
+#ifndef CSV_MANAGER_NO_XLSX
+#include "xlsx_writer.h"
+#endif
+
+// Streams matcher output while the run is going. An output row is a daily
+// row followed by a historical row; both are written from wherever they
+// are held, so the combined row is never built and nothing accumulates in
+// memory. The writers flush in blocks, so results reach the disk during
+// the run.
+//
+// The file (.csv, or .xlsx unless CSV_MANAGER_NO_XLSX) is created on the
+// first row, so a run without matches leaves no output behind. Rows go to
+// <path>.partial, which close() renames to path; a writer destroyed without
+// close(), as when the run throws, removes it instead, so a cut-short run
+// never leaves something that looks like a complete result.
+class MatchWriter {
+public:
+    // Throws if the output type is not supported
+    explicit MatchWriter(std::filesystem::path path) : path(std::move(path)) {
+        std::string ext = this->path.extension().u8string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (ext == ".csv") {
+            is_csv = true;
+        }
+        else if (ext == ".xlsx" || ext == ".xls") {
+#ifdef CSV_MANAGER_NO_XLSX
+            throw std::runtime_error("XLSX support is not built in");
+#endif
+        }
+        else {
+            throw std::runtime_error("Unsupported file type");
+        }
+        partial_path = this->path;
+        partial_path += ".partial";
+    }
+
+    MatchWriter(const MatchWriter&) = delete;
+    MatchWriter& operator=(const MatchWriter&) = delete;
+
+    ~MatchWriter() {
+        if (open && !closed) {
+            csv.reset();
+#ifndef CSV_MANAGER_NO_XLSX
+            xlsx.reset();
+#endif
+            std::error_code ec;
+            std::filesystem::remove(partial_path, ec);
+        }
+    }
+
+    const std::filesystem::path& outputPath() const { return path; }
+
+    // Output rows written so far
+    size_t count() const { return rows; }
+
+    // Historical cells may be any range of std::string or std::string_view
+    template <typename HistCells>
+    void write(const Row& daily, const HistCells& hist) {
+        if (!open) start();
+        if (csv) {
+            for (const std::string& cell : daily) csv->field(cell);
+            for (const auto& cell : hist) csv->field(std::string_view(cell));
+            csv->endRow();
+        }
+#ifndef CSV_MANAGER_NO_XLSX
+        else {
+            cells.assign(daily.begin(), daily.end());
+            for (const auto& cell : hist) cells.emplace_back(cell);
+            xlsx->writeRow(cells);
+        }
+#endif
+        ++rows;
+    }
+
+    // Finishes the file and moves it to the output path
+    void close() {
+        if (!open || closed) return;
+        if (csv) csv->close();
+#ifndef CSV_MANAGER_NO_XLSX
+        if (xlsx) xlsx->close();
+#endif
+        std::filesystem::rename(partial_path, path);
+        closed = true;
+    }
+
+private:
+    void start() {
+        if (is_csv) {
+            csv = std::make_unique<CsvWriter>(partial_path);
+        }
+#ifndef CSV_MANAGER_NO_XLSX
+        else {
+            xlsx = std::make_unique<XlsxWriter>(partial_path);
+        }
+#endif
+        open = true;
+    }
+
+    std::filesystem::path path;
+    std::filesystem::path partial_path;
+    std::unique_ptr<CsvWriter> csv;
+#ifndef CSV_MANAGER_NO_XLSX
+    std::unique_ptr<XlsxWriter> xlsx;
+    std::vector<std::string_view> cells; // one XLSX row, reused
+#endif
+    bool is_csv = false;
+    bool open = false;
+    bool closed = false;
+    size_t rows = 0;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+#include <fast_float/fast_float.h>
+
+// No-throw numeric parsing on string_views, built on fast_float. Each
+// function accepts what its std:: counterpart accepts: leading whitespace,
+// an optional sign, then the longest valid number; trailing characters
+// are ignored. Where std::stoi / std::stod would throw, these return false
+// and leave out unchanged.
+
+namespace numeric_detail {
+
+inline const char* skipSpace(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || (*p >= '\t' && *p <= '\r'))) ++p;
+    return p;
+}
+
+// fast_float takes '-' but not '+'; a '+' must be followed by the number
+inline const char* skipPlus(const char* p, const char* end) {
+    if (p < end && *p == '+' && p + 1 < end && p[1] != '-' && p[1] != '+') ++p;
+    return p;
+}
+
+} // namespace numeric_detail
+
+// Like std::stoi: fails on no digits or int32 overflow
+inline bool parseInt(std::string_view text, int32_t& out) {
+    const char* end = text.data() + text.size();
+    const char* p = numeric_detail::skipPlus(numeric_detail::skipSpace(text.data(), end), end);
+    int32_t value = 0;
+    auto result = fast_float::from_chars(p, end, value);
+    if (result.ec != std::errc()) return false;
+    out = value;
+    return true;
+}
+
+// Like std::stod for decimal, inf and nan (hex floats read as their
+// leading 0): fails on no number or out of range
+inline bool parseDouble(std::string_view text, double& out) {
+    const char* end = text.data() + text.size();
+    const char* p = numeric_detail::skipPlus(numeric_detail::skipSpace(text.data(), end), end);
+    double value = 0.0;
+    auto result = fast_float::from_chars(p, end, value);
+    if (result.ec != std::errc()) return false;
+    out = value;
+    return true;
+}
+
+inline int32_t parseIntOr(std::string_view text, int32_t fallback) {
+    int32_t value = fallback;
+    parseInt(text, value);
+    return value;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Group key packed into Words 64-bit words from small per-field codes, so
+// hashing and comparing a key is one or two integer operations instead of
+// a string. Fields are placed by a KeyLayout.
+template <size_t Words>
+struct PackedKey {
+    std::array<uint64_t, Words> words{};
+
+    bool operator==(const PackedKey& other) const { return words == other.words; }
+};
+
+struct PackedKeyHash {
+    template <size_t Words>
+    size_t operator()(const PackedKey<Words>& key) const {
+        uint64_t h = 0;
+        for (uint64_t word : key.words) {
+            // splitmix64 finalizer per word
+            uint64_t x = h ^ word;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            h = x ^ (x >> 31);
+        }
+        return static_cast<size_t>(h);
+    }
+};
+
+// Bit positions of the fields of a packed key. Field i holds values up to
+// the max_values[i] it was built with; a field never straddles two words.
+class KeyLayout {
+public:
+    explicit KeyLayout(const std::vector<uint64_t>& max_values) {
+        size_t word = 0;
+        unsigned shift = 0;
+        for (uint64_t max_value : max_values) {
+            unsigned bits = 1;
+            while (bits < 64 && (max_value >> bits) != 0) bits++;
+            if (shift + bits > 64) {
+                word++;
+                shift = 0;
+            }
+            fields.push_back({ word, shift, bits == 64 ? ~0ull : (1ull << bits) - 1 });
+            shift += bits;
+        }
+        word_count = fields.empty() ? 0 : word + 1;
+    }
+
+    // 64-bit words the key needs
+    size_t words() const { return word_count; }
+
+    // Fields are or-ed in, so key must start zeroed
+    template <size_t Words>
+    void set(PackedKey<Words>& key, size_t field, uint64_t value) const {
+        const Field& f = fields[field];
+        key.words[f.word] |= value << f.shift;
+    }
+
+    template <size_t Words>
+    uint64_t get(const PackedKey<Words>& key, size_t field) const {
+        const Field& f = fields[field];
+        return (key.words[f.word] >> f.shift) & f.mask;
+    }
+
+private:
+    struct Field {
+        size_t word;
+        unsigned shift;
+        uint64_t mask;
+    };
+
+    std::vector<Field> fields;
+    size_t word_count = 0;
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Progress of one run, shared by the worker threads and whatever reports
+// it. Workers only add to relaxed atomic counters, which never blocks and
+// never touches a window; the UI thread polls snapshot() from a timer (a
+// console reporter can poll the same way).
+//
+// The status line and file names change once per stage, not per row, and
+// are kept under a mutex that only snapshot() and those calls take.
+class Progress {
+public:
+    struct Snapshot {
+        uint64_t done = 0;      // work units finished (files, rows, combinations)
+        uint64_t total = 0;
+        uint64_t rows = 0;      // rows scanned
+        uint64_t matches = 0;
+        uint64_t bytes = 0;     // input bytes read
+        std::string current;    // file being worked on, if any
+        std::string status;
+        double seconds = 0.0;   // since start()
+        bool finished = false;
+
+        // Whole percent of done / total
+        int percent() const {
+            if (total == 0) return 0;
+            return static_cast<int>(done >= total ? 100 : done * 100 / total);
+        }
+
+        // Seconds left at the rate so far; negative until there is a rate
+        double etaSeconds() const {
+            if (done == 0 || done >= total) return -1.0;
+            return seconds / static_cast<double>(done) * static_cast<double>(total - done);
+        }
+    };
+
+    // Resets every counter; file_names are the files setCurrentFile() indexes
+    void start(uint64_t total_units = 0, std::vector<std::string> file_names = {}) {
+        {
+            std::lock_guard<std::mutex> lock(text_mutex);
+            names = std::move(file_names);
+            status.clear();
+            started = std::chrono::steady_clock::now();
+        }
+        done.store(0, std::memory_order_relaxed);
+        rows.store(0, std::memory_order_relaxed);
+        matches.store(0, std::memory_order_relaxed);
+        bytes.store(0, std::memory_order_relaxed);
+        current_file.store(0, std::memory_order_relaxed);
+        total.store(total_units, std::memory_order_relaxed);
+        finished.store(false, std::memory_order_release);
+    }
+
+    void setTotal(uint64_t total_units) { total.store(total_units, std::memory_order_relaxed); }
+
+    // Counts a new phase of total_units from zero; rows, matches and bytes carry on
+    void beginPhase(uint64_t total_units) {
+        done.store(0, std::memory_order_relaxed);
+        total.store(total_units, std::memory_order_relaxed);
+    }
+
+    // Names for setCurrentFile(), once the run has listed its files
+    void setFiles(std::vector<std::string> file_names) {
+        std::lock_guard<std::mutex> lock(text_mutex);
+        names = std::move(file_names);
+    }
+
+    void setStatus(std::string text) {
+        std::lock_guard<std::mutex> lock(text_mutex);
+        status = std::move(text);
+    }
+
+    void setCurrentFile(size_t index) { current_file.store(index + 1, std::memory_order_relaxed); }
+
+    void addDone(uint64_t n = 1) { done.fetch_add(n, std::memory_order_relaxed); }
+    void addRows(uint64_t n) { rows.fetch_add(n, std::memory_order_relaxed); }
+    void addMatches(uint64_t n) { matches.fetch_add(n, std::memory_order_relaxed); }
+    void addBytes(uint64_t n) { bytes.fetch_add(n, std::memory_order_relaxed); }
+
+    // Marks the run over; reporters stop updating once they see it
+    void finish() { finished.store(true, std::memory_order_release); }
+
+    bool isFinished() const { return finished.load(std::memory_order_acquire); }
+
+    Snapshot snapshot() const {
+        Snapshot shot;
+        shot.finished = finished.load(std::memory_order_acquire);
+        shot.done = done.load(std::memory_order_relaxed);
+        shot.total = total.load(std::memory_order_relaxed);
+        shot.rows = rows.load(std::memory_order_relaxed);
+        shot.matches = matches.load(std::memory_order_relaxed);
+        shot.bytes = bytes.load(std::memory_order_relaxed);
+        size_t file = current_file.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(text_mutex);
+        if (file > 0 && file <= names.size()) shot.current = names[file - 1];
+        shot.status = status;
+        shot.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        return shot;
+    }
+
+private:
+    std::atomic<uint64_t> done{ 0 };
+    std::atomic<uint64_t> total{ 0 };
+    std::atomic<uint64_t> rows{ 0 };
+    std::atomic<uint64_t> matches{ 0 };
+    std::atomic<uint64_t> bytes{ 0 };
+    std::atomic<size_t> current_file{ 0 }; // index + 1, 0 for none
+    std::atomic<bool> finished{ true };
+
+    mutable std::mutex text_mutex;
+    std::vector<std::string> names;
+    std::string status;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Interns strings to dense integer codes so hot loops can compare integers
+// instead of strings. Codes are assigned in first-seen order starting at 0.
+class StringPool {
+public:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    StringPool() = default;
+
+    // A copy's map would still view the source's strings
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+    StringPool(StringPool&&) = default;
+    StringPool& operator=(StringPool&&) = default;
+
+    uint32_t intern(std::string_view value) {
+        auto it = ids.find(value);
+        if (it != ids.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(strings.size());
+        strings.emplace_back(value);
+        ids.emplace(strings.back(), id);
+        return id;
+    }
+
+    // Returns npos if the value was never interned
+    uint32_t find(std::string_view value) const {
+        auto it = ids.find(value);
+        return it != ids.end() ? it->second : npos;
+    }
+
+    const std::string& str(uint32_t id) const { return strings[id]; }
+    size_t size() const { return strings.size(); }
+
+private:
+    // deque keeps element addresses stable, so the map can key on views into it
+    std::deque<std::string> strings;
+    std::unordered_map<std::string_view, uint32_t> ids;
+};
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Work-stealing thread pool. Every worker owns a deque: tasks a worker
+// submits go on the back of its own deque and it takes them back LIFO,
+// while idle workers steal from the front of the others. Tasks submitted
+// from outside the pool are spread over the deques round-robin.
+//
+// wait() and parallelFor() run queued tasks on the calling thread until
+// their results are ready, so a task may submit subtasks and wait for them
+// without deadlocking the pool.
+class ThreadPool {
+public:
+    // threads == 0 sizes the pool from std::thread::hardware_concurrency()
+    explicit ThreadPool(size_t threads = 0) {
+        if (threads == 0) threads = defaultThreadCount();
+        for (size_t i = 0; i < threads; ++i) queues.push_back(std::make_unique<Queue>());
+        workers.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) workers.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Runs every queued task, then joins the workers
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    static size_t defaultThreadCount() {
+        return std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    size_t size() const { return workers.size(); }
+
+    template <typename F>
+    auto submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+        std::future<Result> future = task->get_future();
+        push([task] { (*task)(); });
+        return future;
+    }
+
+    // Helps with queued tasks until future is ready, then returns its value
+    template <typename T>
+    T wait(std::future<T>& future) {
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!runOne()) future.wait_for(std::chrono::milliseconds(1));
+        }
+        return future.get();
+    }
+
+    // Calls body(begin, end) on chunks of [first, last) of about grain
+    // items, in parallel, and returns when all chunks are done. Exceptions
+    // from body are rethrown here.
+    template <typename Body>
+    void parallelFor(size_t first, size_t last, size_t grain, Body&& body) {
+        if (first >= last) return;
+        grain = std::max<size_t>(1, grain);
+        std::vector<std::future<void>> chunks;
+        chunks.reserve((last - first + grain - 1) / grain);
+        for (size_t begin = first; begin < last; begin += grain) {
+            size_t end = std::min(last, begin + grain);
+            chunks.push_back(submit([&body, begin, end] { body(begin, end); }));
+        }
+        // Every chunk refers to body, so all of them finish before a rethrow
+        std::exception_ptr error;
+        for (std::future<void>& chunk : chunks) {
+            try {
+                wait(chunk);
+            }
+            catch (...) {
+                if (!error) error = std::current_exception();
+            }
+        }
+        if (error) std::rethrow_exception(error);
+    }
+
+    // Grain that gives every worker a few chunks to balance uneven work
+    size_t grainFor(size_t items) const {
+        return std::max<size_t>(1, items / (size() * 4));
+    }
+
+private:
+    using Task = std::function<void()>;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    static size_t& currentIndex() {
+        thread_local size_t index = SIZE_MAX;
+        return index;
+    }
+
+    static ThreadPool*& currentPool() {
+        thread_local ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    // Index of the calling worker, or SIZE_MAX outside this pool
+    size_t selfIndex() const { return currentPool() == this ? currentIndex() : SIZE_MAX; }
+
+    void push(Task task) {
+        size_t self = selfIndex();
+        size_t index = self != SIZE_MAX ? self : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        // Counted first so queued never drops below the tasks in the deques
+        queued.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+        }
+        wake.notify_one();
+    }
+
+    bool popOwn(size_t self, Task& task) {
+        Queue& queue = *queues[self];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) return false;
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t self, Task& task) {
+        size_t count = queues.size();
+        size_t start = self != SIZE_MAX ? self + 1 : next_queue.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            size_t victim = (start + i) % count;
+            if (victim == self) continue;
+            Queue& queue = *queues[victim];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) continue;
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    // Runs one queued task on the calling thread, if there is one
+    bool runOne() {
+        if (queued.load() == 0) return false;
+        size_t self = selfIndex();
+        Task task;
+        if ((self != SIZE_MAX && popOwn(self, task)) || steal(self, task)) {
+            queued.fetch_sub(1);
+            task();
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(size_t index) {
+        currentPool() = this;
+        currentIndex() = index;
+        for (;;) {
+            if (runOne()) continue;
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+            if (stopping && queued.load() == 0) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queued{ 0 };
+    std::atomic<size_t> next_queue{ 0 };
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A sheet cell read without a format-then-parse round trip. Integers are
+// held as int32; other cells keep their text. An int32 cell only carries
+// text when its source spelling is not the canonical decimal (e.g. "007").
+struct TypedCell {
+    enum class Kind : uint8_t { Empty, Int32, Double, Text };
+
+    Kind kind = Kind::Empty;
+    int32_t int_value = 0;
+    double number = 0.0;
+    std::string text;
+
+    bool isInt() const { return kind == Kind::Int32; }
+
+    // Text as the string readers would have produced it
+    std::string toString() const {
+        if (kind == Kind::Int32 && text.empty()) return std::to_string(int_value);
+        return text;
+    }
+
+    static TypedCell fromInt(int32_t value) {
+        TypedCell cell;
+        cell.kind = Kind::Int32;
+        cell.int_value = value;
+        cell.number = value;
+        return cell;
+    }
+
+    // Classifies a CSV field: whole-field integers become int32
+    static TypedCell fromText(std::string_view field) {
+        TypedCell cell;
+        if (field.empty()) return cell;
+        int32_t value = 0;
+        auto [end, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+        if (ec == std::errc() && end == field.data() + field.size()) {
+            cell = fromInt(value);
+            if (std::to_string(value).size() != field.size()) cell.text.assign(field);
+            return cell;
+        }
+        cell.kind = Kind::Text;
+        cell.text.assign(field);
+        return cell;
+    }
+};
+
+using TypedRow = std::vector<TypedCell>;
+using TypedFrame = std::vector<TypedRow>;
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+#include <xlnt/xlnt.hpp>
+#include <xlnt/workbook/streaming_workbook_reader.hpp>
+#include "column_projection.h"
+#include "data_frame.h"
+#include "typed_cell.h"
+
+// Row-streaming XLSX reader built on xlnt::streaming_workbook_reader. Cells
+// are decoded one at a time from the first worksheet's XML and handed out a
+// row at a time, so no workbook DOM is built and memory stays bounded by
+// one row.
+//
+// Rows are anchored at A1: missing cells and rows come out as empty
+// strings, the same as worksheet::rows(false) for sheets that start at A1.
+// forEachRow rows are as wide as their last present cell; readAll pads every
+// row to the widest one. Cells outside the projection are not converted to
+// text and come out empty. The typed variants return TypedCells instead.
+class XlsxReader {
+public:
+    explicit XlsxReader(const std::filesystem::path& path, ColumnProjection projection = {})
+        : path(path), projection(std::move(projection)) {}
+
+    template <typename OnRow>
+    void forEachRow(OnRow&& on_row) const {
+        forEachCellRow<Row>([](const xlnt::cell& cell) { return cell.to_string(); }, on_row);
+    }
+
+    // Like forEachRow, but integers in General format are read with
+    // cell::value<double>() instead of being formatted as text
+    template <typename OnRow>
+    void forEachTypedRow(OnRow&& on_row) const {
+        forEachCellRow<TypedRow>(readTypedCell, on_row);
+    }
+
+    DataFrame readAll() const { return collect<Row>([&](auto&& on_row) { forEachRow(on_row); }); }
+
+    TypedFrame readAllTyped() const { return collect<TypedRow>([&](auto&& on_row) { forEachTypedRow(on_row); }); }
+
+    static DataFrame read(const std::filesystem::path& path, const ColumnProjection& projection = {}) {
+        return XlsxReader(path, projection).readAll();
+    }
+
+    static TypedFrame readTyped(const std::filesystem::path& path, const ColumnProjection& projection = {}) {
+        return XlsxReader(path, projection).readAllTyped();
+    }
+
+private:
+    static TypedCell readTypedCell(const xlnt::cell& cell) {
+        switch (cell.data_type()) {
+        case xlnt::cell_type::empty:
+            return TypedCell();
+        case xlnt::cell_type::number: {
+            double value = cell.value<double>();
+            bool general = !cell.has_format() || cell.number_format() == xlnt::number_format::general();
+            if (general && value >= INT32_MIN && value <= INT32_MAX && value == static_cast<int32_t>(value)) {
+                return TypedCell::fromInt(static_cast<int32_t>(value));
+            }
+            TypedCell typed;
+            typed.kind = TypedCell::Kind::Double;
+            typed.number = value;
+            typed.text = cell.to_string();
+            return typed;
+        }
+        default: {
+            TypedCell typed;
+            typed.kind = TypedCell::Kind::Text;
+            typed.text = cell.to_string();
+            return typed;
+        }
+        }
+    }
+
+    // Decodes the first worksheet, converting projected cells with convert
+    template <typename RowType, typename Convert, typename OnRow>
+    void forEachCellRow(Convert&& convert, OnRow&& on_row) const {
+        xlnt::streaming_workbook_reader reader;
+#ifdef _MSC_VER
+        reader.open(path.wstring());
+#else
+        reader.open(path.u8string());
+#endif
+        std::vector<std::string> titles = reader.sheet_titles();
+        if (titles.empty()) return;
+        reader.begin_worksheet(titles.front());
+
+        RowType row;
+        xlnt::row_t current_row = 0;
+        while (reader.has_cell()) {
+            xlnt::cell cell = reader.read_cell();
+            xlnt::row_t cell_row = cell.row();
+            if (current_row == 0) current_row = 1;
+            while (current_row < cell_row) {
+                on_row(static_cast<const RowType&>(row));
+                row.clear();
+                ++current_row;
+            }
+            size_t col = cell.column_index();
+            if (row.size() < col) row.resize(col);
+            if (projection.contains(col - 1)) row[col - 1] = convert(cell);
+        }
+        if (current_row != 0) on_row(static_cast<const RowType&>(row));
+        reader.end_worksheet();
+    }
+
+    // Copies every row and pads them to the widest one
+    template <typename RowType, typename ForEach>
+    static std::vector<RowType> collect(ForEach&& for_each) {
+        std::vector<RowType> data;
+        size_t width = 0;
+        for_each([&](const RowType& row) {
+            width = std::max(width, row.size());
+            data.push_back(row);
+        });
+        for (RowType& row : data) row.resize(width);
+        return data;
+    }
+
+    std::filesystem::path path;
+    ColumnProjection projection;
+};
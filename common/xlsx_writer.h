@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <xlnt/xlnt.hpp>
+#include <xlnt/workbook/streaming_workbook_writer.hpp>
+#include "data_frame.h"
+
+// Row-streaming XLSX writer built on xlnt::streaming_workbook_writer. Each
+// row is serialized into the package as it is written, so memory does not
+// grow with the row count. Empty cells are left out.
+//
+// A sheet holds at most kMaxSheetRows rows; further rows go on to new
+// sheets named "<title>2", "<title>3" and so on.
+class XlsxWriter {
+public:
+    static constexpr uint32_t kMaxSheetRows = 1048576;
+
+    explicit XlsxWriter(const std::filesystem::path& path, const std::string& title = "Sheet")
+        : title(title) {
+#ifdef _MSC_VER
+        writer.open(path.wstring());
+#else
+        writer.open(path.u8string());
+#endif
+        writer.add_worksheet(title + "1");
+    }
+
+    // Cells may be any range of std::string or std::string_view
+    template <typename Cells>
+    void writeRow(const Cells& cells) {
+        if (sheet_rows == kMaxSheetRows) {
+            writer.add_worksheet(title + std::to_string(++sheet_count));
+            sheet_rows = 0;
+        }
+        ++sheet_rows;
+        uint32_t col = 0;
+        for (const auto& cell : cells) {
+            ++col;
+            if (cell.empty()) continue;
+            writer.add_cell(xlnt::cell_reference(col, sheet_rows)).value(std::string(cell));
+        }
+    }
+
+    // Finishes the package; called by the destructor if not called before
+    void close() { writer.close(); }
+
+    static void write(const DataFrame& data, const std::filesystem::path& path) {
+        XlsxWriter writer(path);
+        for (const Row& row : data) writer.writeRow(row);
+        writer.close();
+    }
+
+private:
+    xlnt::streaming_workbook_writer writer;
+    std::string title;
+    uint32_t sheet_count = 1;
+    uint32_t sheet_rows = 0;
+};
@@ -0,0 +1,65 @@
+// Console front end of the file splitter, for batch servers and cron.
+//
+// file_split --input FILE --column LETTER [--output FOLDER] [--threads N] [--quiet]
+
+#include <iostream>
+#include <string>
+#include "../common/cli_args.h"
+#include "../common/console_progress.h"
+#include "../common/progress.h"
+#include "file_split.h"
+
+namespace {
+
+const char* kUsage =
+    "Usage: file_split --input FILE --column LETTER [options]\n"
+    "\n"
+    "Writes one split_<column>_<value> file per distinct value of the column,\n"
+    "in the format of the input.\n"
+    "\n"
+    "Options:\n"
+    "  --output FOLDER    output folder (default <input>_output)\n"
+    "  --threads N        writer threads, 0 for all cores (default 0)\n"
+    "  --quiet            no progress on stderr\n";
+
+std::string formatProgress(const Progress::Snapshot& shot) {
+    if (shot.total == 0) return shot.status;
+    return "Writing files: " + std::to_string(shot.done) + "/" + std::to_string(shot.total);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        CliArgs args(argc, argv, { "--input", "--column", "--output", "--threads" }, { "--quiet" });
+        if (args.flag("--help")) {
+            std::cout << kUsage;
+            return 0;
+        }
+        std::filesystem::path file_path = std::filesystem::u8path(args.require("--input"));
+        std::string column_letter = args.require("--column");
+        if (col_letter_to_index(column_letter) < 0) throw UsageError("Not a column letter: " + column_letter);
+        std::filesystem::path output_dir = args.has("--output")
+            ? std::filesystem::u8path(args.get("--output"))
+            : default_split_output_dir(file_path);
+        size_t threads = args.threads();
+
+        Progress progress;
+        progress.start();
+        ConsoleProgress reporter(progress, formatProgress, !args.flag("--quiet"));
+        size_t files = split_file_by_column(file_path, column_letter, output_dir, threads, progress);
+        progress.finish();
+        reporter.stop();
+
+        std::cout << "Split complete! " << files << " files saved in: " << output_dir.u8string() << std::endl;
+        return 0;
+    }
+    catch (const UsageError& e) {
+        std::cerr << e.what() << "\n\n" << kUsage;
+        return 2;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
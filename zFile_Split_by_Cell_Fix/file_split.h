@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cwctype>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../common/csv_manager.h"
+#include "../common/progress.h"
+#include "../common/thread_pool.h"
+
+// Splitting core shared by the Win32 GUI (main.cpp) and the console tool
+// (cli.cpp). Counts written files through a Progress and throws on errors;
+// it never touches a window.
+
+// Function to convert column letter to index (A=0, B=1, etc.)
+inline int col_letter_to_index(const std::string& letter) {
+    std::string upper_letter = letter;
+    std::transform(upper_letter.begin(), upper_letter.end(), upper_letter.begin(), ::toupper);
+    
+    int total = 0;
+    for (int i = 0; i < static_cast<int>(upper_letter.length()); ++i) {
+        char c = upper_letter[upper_letter.length() - 1 - i];
+        if (c >= 'A' && c <= 'Z') {
+            total += (c - 'A' + 1) * static_cast<int>(std::pow(26, i));
+        }
+    }
+    return total - 1;
+}
+
+// Output file for one group of split_file_by_column
+inline std::filesystem::path groupOutputPath(const std::string& group_key, const std::string& column_letter, const std::filesystem::path& ext, const std::filesystem::path& output_dir) {
+    std::string safe_name = group_key;
+    // Replace invalid characters for filename
+    std::replace(safe_name.begin(), safe_name.end(), '/', '_');
+    std::replace(safe_name.begin(), safe_name.end(), '\\', '_');
+    
+    std::filesystem::path output_filename = std::filesystem::u8path("split_" + column_letter + "_" + safe_name);
+    output_filename += ext;
+    return output_dir / output_filename;
+}
+
+// Output folder next to the input: <file name without extension>_output
+inline std::filesystem::path default_split_output_dir(const std::filesystem::path& file_path) {
+    std::filesystem::path output_dir = file_path;
+    output_dir.replace_extension();
+    output_dir += "_output";
+    return output_dir;
+}
+
+// Writes one file per distinct value of column_letter into output_dir, in
+// the input's format. Returns the number of files written.
+inline size_t split_file_by_column(const std::filesystem::path& file_path, const std::string& column_letter,
+                                   const std::filesystem::path& output_dir, size_t threads, Progress& progress) {
+    // Read the file
+    progress.setStatus("Reading file...");
+    DataFrame df = CSVManager::read(file_path);
+    if (df.empty()) {
+        throw std::runtime_error("The file is empty.");
+    }
+    progress.addRows(df.size());
+    
+    // Convert column letter to index
+    int col_index = col_letter_to_index(column_letter);
+    if (col_index >= static_cast<int>(df[0].size())) {
+        throw std::runtime_error("Column letter exceeds available columns in the file.");
+    }
+    
+    std::filesystem::create_directories(output_dir);
+    
+    // Group data by the specified column
+    std::map<std::string, DataFrame> grouped_data;
+    for (const auto& row : df) {
+        if (col_index < static_cast<int>(row.size())) {
+            std::string group_key = row[col_index];
+            grouped_data[group_key].push_back(row);
+        }
+    }
+    
+    // Get file extension
+    std::wstring ext = file_path.extension().wstring();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::towlower);
+    
+    // Write separate files for each group, in parallel. Names that differ
+    // only in case are one file on NTFS and APFS, so groups whose names fold
+    // together are written by one job in key order: the last group wins, as
+    // sequential writes did.
+    std::map<std::wstring, std::vector<std::pair<std::filesystem::path, const DataFrame*>>> jobs_by_name;
+    std::set<std::filesystem::path> files;
+    for (const auto& group : grouped_data) {
+        std::filesystem::path path = groupOutputPath(group.first, column_letter, ext, output_dir);
+        std::wstring folded = path.filename().wstring();
+        std::transform(folded.begin(), folded.end(), folded.begin(), ::towlower);
+        jobs_by_name[folded].emplace_back(path, &group.second);
+        files.insert(path);
+    }
+    std::vector<const std::vector<std::pair<std::filesystem::path, const DataFrame*>>*> jobs;
+    size_t writes = 0;
+    for (const auto& [name, job] : jobs_by_name) {
+        jobs.push_back(&job);
+        writes += job.size();
+    }
+    progress.setStatus("Writing files...");
+    progress.setTotal(writes);
+    ThreadPool pool(threads);
+    pool.parallelFor(0, jobs.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j) {
+            for (const auto& [path, data] : *jobs[j]) {
+                CSVManager::write(*data, path);
+                progress.addDone();
+            }
+        }
+    });
+    return files.size();
+}
@@ -0,0 +1,329 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <iterator>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../common/column_projection.h"
+#include "../common/combination_counter.h"
+#include "../common/csv_manager.h"
+#include "../common/csv_writer.h"
+#include "../common/data_frame.h"
+#include "../common/progress.h"
+#include "../common/thread_pool.h"
+
+// Bulk processing core shared by the Win32 GUI (main.cpp) and the console
+// tool (cli.cpp). Logs to the console and counts finished workbooks in a
+// Progress; it never touches a window.
+
+namespace fs = std::filesystem;
+
+// Files run concurrently, so every console line goes out whole under cout_mutex
+inline void log_line(const std::string &line) {
+    static std::mutex cout_mutex;
+    std::lock_guard<std::mutex> lock(cout_mutex);
+    std::cout << line << std::endl;
+}
+
+// Correct column mapping matching Python version
+inline const std::map<std::string, int> COLUMN_MAPPING = {
+    {"AP", 41}, {"AR", 43}, {"AT", 45}, {"AV", 47}, {"AX", 49},
+    {"AZ", 51}, {"BB", 53}, {"BD", 55}, {"BF", 57}, {"BH", 59}, {"BJ", 61}
+};
+
+// ==== Excel/CSV Utilities ====
+inline std::string get_next_column(const std::string &col) {
+    char a = col[0], b = col[1];
+    b++;
+    if (b > 'Z') { 
+        b = 'A'; 
+        a++; 
+    }
+    return std::string(1, a) + std::string(1, b);
+}
+
+inline void write_csv(std::string_view rows, const std::string &filename) {
+    try {
+        CsvWriter writer(fs::u8path(filename));
+        writer.append(rows);
+        writer.close();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+    }
+}
+
+inline DataFrame read_excel(const std::string &path, const ColumnProjection &projection = {}) {
+    DataFrame df;
+    try {
+        df = CSVManager::read(fs::u8path(path), projection);
+    } catch (const std::exception& e) {
+        std::cerr << "Error reading Excel file: " << e.what() << std::endl;
+    }
+    return df;
+}
+
+// Columns the combinations count over: the mapped columns in
+// COLUMN_MAPPING order, each followed by its degree column (the next
+// Excel column) with is_degree
+inline std::vector<int> counted_columns(bool is_degree) {
+    std::vector<int> columns;
+    for (const auto &[name, idx] : COLUMN_MAPPING) {
+        columns.push_back(idx);
+        if (is_degree) columns.push_back(idx + 1);
+    }
+    return columns;
+}
+
+// Positions of a combination's columns in counted_columns(is_degree)
+inline std::vector<size_t> combination_positions(const std::vector<std::pair<std::string,int>> &comb, bool is_degree) {
+    size_t width = is_degree ? 2 : 1;
+    std::vector<size_t> positions;
+    for (auto &item : comb) {
+        size_t slot = static_cast<size_t>(std::distance(COLUMN_MAPPING.begin(), COLUMN_MAPPING.find(item.first)));
+        for (size_t i = 0; i < width; i++) positions.push_back(slot * width + i);
+    }
+    return positions;
+}
+
+// Bit mask of a combination's items, one bit per COLUMN_MAPPING entry
+inline uint32_t combination_mask(const std::vector<std::pair<std::string,int>> &comb) {
+    uint32_t mask = 0;
+    for (auto &item : comb) {
+        mask |= uint32_t(1) << std::distance(COLUMN_MAPPING.begin(), COLUMN_MAPPING.find(item.first));
+    }
+    return mask;
+}
+
+// Where an output field comes from. Rows list "Col_<i>" (column name),
+// "Col_<i>_val", "Total" and "WIN% OVER" in sorted name order, as the
+// Python version wrote its per-group dicts
+struct OutputField {
+    enum Kind { Name, Value, Total, WinOver } kind;
+    size_t column;
+};
+
+inline std::vector<OutputField> output_fields(size_t selected_count) {
+    std::map<std::string, OutputField> fields;
+    for (size_t i = 0; i < selected_count; i++) {
+        // Col_0 is the player, which has no name field
+        if (i > 0) fields["Col_" + std::to_string(i)] = { OutputField::Name, i };
+        fields["Col_" + std::to_string(i) + "_val"] = { OutputField::Value, i };
+    }
+    fields["Total"] = { OutputField::Total, 0 };
+    fields["WIN% OVER"] = { OutputField::WinOver, 0 };
+    std::vector<OutputField> ordered;
+    for (const auto &[name, field] : fields) ordered.push_back(field);
+    return ordered;
+}
+
+// Writes one output row per group of a combination (matching Python logic
+// exactly); groups come in the order of their "player|value|...|" keys
+inline void process_file(const EncodedRows &rows, bool is_degree, const std::vector<std::pair<std::string,int>> &comb,
+                         const std::vector<size_t> &positions, const std::vector<CountedGroup> &groups, CsvWriter &csv_data) {
+    // Build column selection like Python
+    std::vector<std::string> selected_columns = {"Player"};
+    std::vector<int> col_indexes = {0};
+    
+    for (auto &item : comb) {
+        selected_columns.push_back(item.first);
+        col_indexes.push_back(item.second);
+        
+        if (is_degree) {
+            selected_columns.push_back(get_next_column(item.first));
+            // For degree columns, the index should be the next consecutive index
+            // Since Excel columns are consecutive, we just add 1 to the original index
+            col_indexes.push_back(item.second + 1);
+        }
+    }
+    
+    // Debug: Print the exact column selection to match Python
+    std::ostringstream selection;
+    selection << "Column selection (matching Python):";
+    for (size_t i = 0; i < selected_columns.size(); i++) {
+        selection << "\n  " << selected_columns[i] << " -> index " << col_indexes[i];
+    }
+    log_line(selection.str());
+    
+    std::vector<OutputField> fields = output_fields(selected_columns.size());
+    for (const CountedGroup &group : groups) {
+        int total = group.counts.over + group.counts.under;
+        
+        for (const OutputField &field : fields) {
+            switch (field.kind) {
+            case OutputField::Name:
+                csv_data.field(selected_columns[field.column]);
+                break;
+            case OutputField::Value:
+                csv_data.field(field.column == 0 ? rows.player(group.key.codes[0])
+                                                 : rows.value(positions[field.column - 1], group.key.codes[field.column]));
+                break;
+            case OutputField::Total:
+                csv_data.field(total);
+                break;
+            case OutputField::WinOver: {
+                // Python: round(over / total, 2) - gives decimal between 0 and 1,
+                // written with six decimals as std::to_string did
+                double win_percentage = (double)group.counts.over / total;
+                win_percentage = std::round(win_percentage * 100.0) / 100.0;
+                csv_data.field(win_percentage, 6);
+                break;
+            }
+            }
+        }
+        csv_data.endRow();
+    }
+}
+
+inline void combinations(const std::vector<std::pair<std::string,int>> &items, int k, int start,
+                  std::vector<std::pair<std::string,int>> &cur,
+                  std::vector<std::vector<std::pair<std::string,int>>> &res) {
+    if ((int)cur.size() == k) {
+        res.push_back(cur);
+        return;
+    }
+    for (int i = start; i < (int)items.size(); i++) {
+        cur.push_back(items[i]);
+        combinations(items, k, i + 1, cur, res);
+        cur.pop_back();
+    }
+}
+
+// Groups with fewer than min_support rows are left out (0 or 1 keeps all);
+// the set sizes below k are then counted first, each pruning the next
+inline void process_excel_file(const fs::path &file, bool deg, int k, const fs::path &out, int min_support) {
+    try {
+        log_line("→ " + file.filename().u8string() + " started");
+        
+        // Only Player, the result column and the mapped (and degree) columns are read
+        ColumnProjection projection{0, 7};
+        for (const auto &[name, idx] : COLUMN_MAPPING) {
+            projection.add(idx);
+            if (deg) projection.add(idx + 1);
+        }
+        DataFrame df = read_excel(file.u8string(), projection);
+        if (df.empty()) {
+            log_line("Error: Empty or invalid Excel file");
+            return;
+        }
+        
+        std::vector<std::pair<std::string,int>> items(COLUMN_MAPPING.begin(), COLUMN_MAPPING.end());
+        
+        // Every combination is counted over the same encoded rows, a batch
+        // of combinations per pass; a column past the end of a short row
+        // groups as an empty cell
+        EncodedRows rows(df, 7, counted_columns(deg), true);
+        df.clear();
+        
+        // Rows are formatted in memory and written once the file is done
+        CsvWriter csv_data;
+        std::unique_ptr<RowSupport> below;
+        std::vector<uint32_t> below_masks;
+        for (int size = min_support > 1 ? 1 : k; size <= k; size++) {
+            std::vector<std::vector<std::pair<std::string,int>>> combos; 
+            std::vector<std::pair<std::string,int>> cur;
+            combinations(items, size, 0, cur, combos);
+            
+            std::vector<std::vector<size_t>> positions;
+            std::vector<uint32_t> masks;
+            for (const auto &combo : combos) {
+                positions.push_back(combination_positions(combo, deg));
+                masks.push_back(combination_mask(combo));
+            }
+            CombinationCounter counter(rows, positions, true);
+            
+            SupportPruning pruning;
+            std::unique_ptr<RowSupport> reached;
+            if (min_support > 1) {
+                pruning.min_support = min_support;
+                pruning.below = below.get();
+                if (below) pruning.subsets = subsetIndices(masks, below_masks);
+                if (size < k) {
+                    reached = std::make_unique<RowSupport>(rows.size(), combos.size());
+                    pruning.reached = reached.get();
+                }
+                counter.prune(&pruning);
+            }
+            
+            for (size_t first = 0; first < combos.size(); first += CombinationCounter::kBatchSize) {
+                size_t last = std::min(combos.size(), first + CombinationCounter::kBatchSize);
+                auto batch = counter.countBatch(first, last);
+                for (size_t i = first; i < last && size == k; i++) {
+                    std::string combo_line = "  Combo " + std::to_string(i+1) + "/" + std::to_string(combos.size()) + ": ";
+                    for (const auto& c : combos[i]) {
+                        combo_line += c.first + " ";
+                    }
+                    log_line(combo_line);
+                    
+                    process_file(rows, deg, combos[i], positions[i], batch[i - first], csv_data);
+                }
+            }
+            below = std::move(reached);
+            below_masks = std::move(masks);
+        }
+        
+        std::string csv_rows = csv_data.take();
+        if (!csv_rows.empty()) {
+            std::string output_name = file.stem().u8string() + "_Size_" + std::to_string(k) + 
+                                    "_Degree_" + (deg ? "YES" : "NO") + ".csv";
+            fs::path output_path = out / fs::u8path(output_name);
+            write_csv(csv_rows, output_path.u8string());
+            log_line("✓ Saved to " + output_path.u8string());
+        }
+        
+        log_line(file.filename().u8string() + " completed");
+        
+    } catch (const std::exception& e) {
+        log_line(file.u8string() + " failed: " + e.what());
+    }
+}
+
+// Output folder of a run: <input folder>_output
+inline fs::path default_output_dir(const fs::path &in) {
+    fs::path out = in;
+    out += "_output";
+    return out;
+}
+
+// Processes every .xlsx workbook of in (Office lock files skipped) into out,
+// one pool task per workbook on threads workers (0 for all cores), leaving
+// out groups with fewer than min_support rows. A workbook that fails is
+// logged and skipped. Returns the workbook count.
+inline size_t RunProcessing(const fs::path &in, bool deg, int set_size, int min_support, const fs::path &out, size_t threads, Progress &progress) {
+    fs::create_directories(out);
+    
+    std::vector<fs::path> files;
+    for (auto &e : fs::directory_iterator(in)) {
+        if (e.path().extension() == ".xlsx" && 
+            e.path().filename().u8string().substr(0, 2) != "~$") {
+            files.push_back(e.path());
+        }
+    }
+    std::vector<std::string> file_names;
+    for (const auto &file : files) file_names.push_back(file.filename().u8string());
+    progress.setFiles(std::move(file_names));
+    progress.setTotal(files.size());
+    
+    // One pool task per workbook; each writes its own output file
+    ThreadPool pool(threads);
+    std::vector<std::future<void>> tasks;
+    for (size_t i = 0; i < files.size(); ++i) {
+        fs::path file = files[i];
+        tasks.push_back(pool.submit([file, i, deg, set_size, min_support, out, &progress] {
+            progress.setCurrentFile(i);
+            process_excel_file(file, deg, set_size, out, min_support);
+            progress.addDone();
+        }));
+    }
+    for (auto &task : tasks) pool.wait(task);
+    return files.size();
+}
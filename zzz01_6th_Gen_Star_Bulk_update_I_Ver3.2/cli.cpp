@@ -0,0 +1,70 @@
+// Console front end of the bulk Excel processor, for batch servers and cron.
+//
+// zzz01 --input FOLDER [--output FOLDER] [--set-size 3..8] [--degrees]
+//       [--min-support N] [--threads N] [--quiet]
+
+#include <iostream>
+#include <string>
+#include "../common/cli_args.h"
+#include "../common/console_progress.h"
+#include "../common/progress.h"
+#include "bulk_processing.h"
+
+namespace {
+
+const char* kUsage =
+    "Usage: zzz01 --input FOLDER [options]\n"
+    "\n"
+    "Groups every combination of the mapped columns in each .xlsx workbook of\n"
+    "FOLDER and writes one <file>_Size_<n>_Degree_<YES|NO>.csv per workbook.\n"
+    "Needs a build with TOOLS_WITH_XLSX.\n"
+    "\n"
+    "Options:\n"
+    "  --output FOLDER    output folder (default <input>_output)\n"
+    "  --set-size N       columns per combination, 3 to 8 (default 3)\n"
+    "  --degrees          include the degree column next to each mapped column\n"
+    "  --min-support N    leave out groups with a Total below N; smaller set\n"
+    "                     sizes are counted first to skip them (default 1)\n"
+    "  --threads N        worker threads, 0 for all cores (default 0)\n"
+    "  --quiet            no progress on stderr\n";
+
+std::string formatProgress(const Progress::Snapshot& shot) {
+    if (shot.total == 0) return {};
+    return "Processed " + std::to_string(shot.done) + "/" + std::to_string(shot.total) + " workbooks";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        CliArgs args(argc, argv, { "--input", "--output", "--set-size", "--min-support", "--threads" }, { "--degrees", "--quiet" });
+        if (args.flag("--help")) {
+            std::cout << kUsage;
+            return 0;
+        }
+        fs::path in = fs::u8path(args.require("--input"));
+        fs::path out = args.has("--output") ? fs::u8path(args.get("--output")) : default_output_dir(in);
+        int set_size = args.getInt("--set-size", 3);
+        if (set_size < 3 || set_size > 8) throw UsageError("--set-size must be between 3 and 8");
+        int min_support = args.getInt("--min-support", 1);
+        if (min_support < 0) throw UsageError("--min-support must not be negative");
+
+        Progress progress;
+        progress.start();
+        ConsoleProgress reporter(progress, formatProgress, !args.flag("--quiet"));
+        size_t workbooks = RunProcessing(in, args.flag("--degrees"), set_size, min_support, out, args.threads(), progress);
+        progress.finish();
+        reporter.stop();
+
+        std::cout << "Processing Complete! " << workbooks << " workbooks, output in: " << out.u8string() << std::endl;
+        return 0;
+    }
+    catch (const UsageError& e) {
+        std::cerr << e.what() << "\n\n" << kUsage;
+        return 2;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -2,263 +2,16 @@
 #include <commdlg.h>
 #include <shlobj.h>
 #include <thread>
-#include <mutex>
 #include <string>
 #include <vector>
-#include <map>
 #include <filesystem>
-#include <algorithm>
-#include <iostream>
-#include <fstream>
-#include <sstream>
-#include <iomanip>
-#include <xlnt/xlnt.hpp>
-
-namespace fs = std::filesystem;
-using Row = std::vector<std::string>;
-using DataFrame = std::vector<Row>;
+#include <cstring>
+#include "../common/progress.h"
+#include "bulk_processing.h"
 // This C++ code is a GUI application that processes Excel files in bulk, similar to a Python script.
 // ==== Globals ====
-HWND hInputEntry, hStatus, hProcessBtn, hDegreeCheck;
+HWND hInputEntry, hStatus, hProcessBtn, hDegreeCheck, hMinSupportEntry;
 HWND hRadioBtns[6];
-std::mutex cout_mutex;
-
-// Correct column mapping matching Python version
-std::map<std::string, int> COLUMN_MAPPING = {
-    {"AP", 41}, {"AR", 43}, {"AT", 45}, {"AV", 47}, {"AX", 49},
-    {"AZ", 51}, {"BB", 53}, {"BD", 55}, {"BF", 57}, {"BH", 59}, {"BJ", 61}
-};
-
-// ==== Excel/CSV Utilities ====
-std::string get_next_column(const std::string &col) {
-    char a = col[0], b = col[1];
-    b++;
-    if (b > 'Z') { 
-        b = 'A'; 
-        a++; 
-    }
-    return std::string(1, a) + std::string(1, b);
-}
-
-void write_csv(const DataFrame &data, const std::string &filename) {
-    std::ofstream f(filename);
-    if (!f.is_open()) {
-        std::cerr << "Error: Cannot open file " << filename << std::endl;
-        return;
-    }
-    
-    for (const auto &row : data) {
-        for (size_t i = 0; i < row.size(); i++) {
-            if (i) f << ",";
-            f << row[i];
-        }
-        f << "\n";
-    }
-}
-
-DataFrame read_excel(const std::string &path) {
-    DataFrame df;
-    try {
-        xlnt::workbook wb; 
-        wb.load(path);
-        auto ws = wb.active_sheet();
-        for (auto r : ws.rows(false)) {
-            Row row; 
-            for (auto c : r) {
-                row.push_back(c.to_string());
-            }
-            df.push_back(row);
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "Error reading Excel file: " << e.what() << std::endl;
-    }
-    return df;
-}
-
-// Process file function matching Python logic exactly
-std::vector<std::map<std::string, std::string>> process_file(const DataFrame &df, bool is_degree,
-                       const std::vector<std::pair<std::string,int>> &comb) {
-    std::vector<std::map<std::string, std::string>> output_rows;
-    
-    // Build column selection like Python
-    std::vector<std::string> selected_columns = {"Player"};
-    std::vector<int> col_indexes = {0};
-    
-    for (auto &item : comb) {
-        selected_columns.push_back(item.first);
-        col_indexes.push_back(item.second);
-        
-        if (is_degree) {
-            selected_columns.push_back(get_next_column(item.first));
-            // For degree columns, the index should be the next consecutive index
-            // Since Excel columns are consecutive, we just add 1 to the original index
-            col_indexes.push_back(item.second + 1);
-        }
-    }
-    
-    // Debug: Print the exact column selection to match Python
-    std::cout << "Column selection (matching Python):" << std::endl;
-    for (size_t i = 0; i < selected_columns.size(); i++) {
-        std::cout << "  " << selected_columns[i] << " -> index " << col_indexes[i] << std::endl;
-    }
-    
-    // Group data by selected columns (matching Python's groupby)
-    std::map<std::string, std::vector<Row>> groups;
-    
-    for (const auto &row : df) {
-        if (row.size() <= 7) continue;
-        
-        // Create group key using all selected columns (matching Python's groupby)
-        std::string group_key;
-        for (int idx : col_indexes) {
-            if (idx < (int)row.size()) {
-                group_key += row[idx] + "|";
-            } else {
-                group_key += "|";
-            }
-        }
-        
-        // Store the row with its result
-        Row group_row;
-        for (int idx : col_indexes) {
-            if (idx < (int)row.size()) {
-                group_row.push_back(row[idx]);
-            } else {
-                group_row.push_back("");
-            }
-        }
-        group_row.push_back(row[7]); // Result column (0-based index 7)
-        groups[group_key].push_back(group_row);
-    }
-    
-    // Process each group like Python
-    for (auto &[group_key, group_rows] : groups) {
-        int over = 0, under = 0;
-        
-        // Count results exactly like Python
-        for (const auto &row : group_rows) {
-            if (row.empty()) continue;
-            std::string result = row.back();
-            std::transform(result.begin(), result.end(), result.begin(), ::tolower);
-            
-            if (result == "over") over++;
-            if (result == "win") over++;
-            if (result == "under") under++;
-            if (result == "lose") under++;
-        }
-        
-        int total = over + under;
-        if (total == 0) continue;
-        
-        // Create output row matching Python format exactly
-        std::map<std::string, std::string> row_dict;
-        
-        // Get the first row's values for this group
-        const auto &first_row = group_rows[0];
-        
-        int col_id = 0;
-        for (size_t i = 0; i < selected_columns.size(); i++) {
-            if (selected_columns[i] != "Player") {
-                row_dict["Col_" + std::to_string(col_id)] = selected_columns[i];
-            }
-            row_dict["Col_" + std::to_string(col_id) + "_val"] = 
-                (i < first_row.size()) ? first_row[i] : "";
-            col_id++;
-        }
-        
-        row_dict["Total"] = std::to_string(total);
-        // Python: round(over / total, 2) - gives decimal between 0 and 1
-        double win_percentage = (double)over / total;
-        win_percentage = std::round(win_percentage * 100.0) / 100.0;
-        row_dict["WIN% OVER"] = std::to_string(win_percentage);
-        
-        output_rows.push_back(row_dict);
-    }
-    
-    return output_rows;
-}
-
-void combinations(const std::vector<std::pair<std::string,int>> &items, int k, int start,
-                  std::vector<std::pair<std::string,int>> &cur,
-                  std::vector<std::vector<std::pair<std::string,int>>> &res) {
-    if ((int)cur.size() == k) {
-        res.push_back(cur);
-        return;
-    }
-    for (int i = start; i < (int)items.size(); i++) {
-        cur.push_back(items[i]);
-        combinations(items, k, i + 1, cur, res);
-        cur.pop_back();
-    }
-}
-
-// Convert map to CSV row (matching Python's DataFrame.to_csv behavior)
-Row map_to_csv_row(const std::map<std::string, std::string> &row_dict) {
-    Row csv_row;
-    
-    // Get all keys and sort them to ensure consistent ordering
-    std::vector<std::string> keys;
-    for (const auto &[key, value] : row_dict) {
-        keys.push_back(key);
-    }
-    std::sort(keys.begin(), keys.end());
-    
-    // Add values in sorted key order (matching Python's DataFrame.to_csv)
-    for (const auto &key : keys) {
-        csv_row.push_back(row_dict.at(key));
-    }
-    
-    return csv_row;
-}
-
-void process_excel_file(const fs::path &file, bool deg, int k, const fs::path &out) {
-    try {
-        std::cout << "→ " << file.filename().string() << " started" << std::endl;
-        
-        DataFrame df = read_excel(file.string());
-        if (df.empty()) {
-            std::cout << "Error: Empty or invalid Excel file" << std::endl;
-            return;
-        }
-        
-        std::vector<std::pair<std::string,int>> items(COLUMN_MAPPING.begin(), COLUMN_MAPPING.end());
-        std::vector<std::vector<std::pair<std::string,int>>> combos; 
-        std::vector<std::pair<std::string,int>> cur;
-        combinations(items, k, 0, cur, combos);
-        
-        std::vector<std::map<std::string, std::string>> all_results;
-        
-        for (size_t i = 0; i < combos.size(); i++) {
-            std::cout << "  Combo " << (i+1) << "/" << combos.size() << ": ";
-            for (const auto& c : combos[i]) {
-                std::cout << c.first << " ";
-            }
-            std::cout << std::endl;
-            
-            auto results = process_file(df, deg, combos[i]);
-            all_results.insert(all_results.end(), results.begin(), results.end());
-        }
-        
-        if (!all_results.empty()) {
-            // Convert to DataFrame format for CSV writing
-            DataFrame csv_data;
-            for (const auto &row_dict : all_results) {
-                csv_data.push_back(map_to_csv_row(row_dict));
-            }
-            
-            std::string output_name = file.stem().string() + "_Size_" + std::to_string(k) + 
-                                    "_Degree_" + (deg ? "YES" : "NO") + ".csv";
-            fs::path output_path = out / output_name;
-            write_csv(csv_data, output_path.string());
-            std::cout << "✓ Saved to " << output_path.string() << std::endl;
-        }
-        
-        std::cout << file.filename().string() << " completed" << std::endl;
-        
-    } catch (const std::exception& e) {
-        std::cout << file.string() << " failed: " << e.what() << std::endl;
-    }
-}
 
 // ==== GUI File Picker ====
 std::wstring BrowseFolder() {
@@ -275,18 +28,11 @@ std::wstring BrowseFolder() {
 }
 
 // ==== Threaded Bulk Processing ====
-void RunProcessing(std::wstring folder, bool deg, int set_size) {
+void ProcessFolder(std::wstring folder, bool deg, int set_size, int min_support) {
     try {
         fs::path in = folder; 
-        fs::path out = in.string() + "_output"; 
-        fs::create_directories(out);
-        
-        for (auto &e : fs::directory_iterator(in)) {
-            if (e.path().extension() == ".xlsx" && 
-                e.path().filename().string().substr(0, 2) != "~$") {
-                process_excel_file(e.path(), deg, set_size, out);
-            }
-        }
+        Progress progress;
+        RunProcessing(in, deg, set_size, min_support, default_output_dir(in), 0, progress);
         
         SetWindowTextW(hStatus, L"Processing Complete!");
         EnableWindow(hProcessBtn, TRUE);
@@ -306,6 +52,8 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp) {
             hInputEntry = CreateWindowW(L"EDIT", L"", WS_CHILD | WS_VISIBLE | WS_BORDER, 120, 20, 300, 20, hwnd, 0, 0, 0);
             CreateWindowW(L"BUTTON", L"Browse", WS_CHILD | WS_VISIBLE, 430, 20, 80, 20, hwnd, (HMENU)1, 0, 0);
             hDegreeCheck = CreateWindowW(L"BUTTON", L"Include Degrees", WS_CHILD | WS_VISIBLE | BS_AUTOCHECKBOX, 10, 60, 150, 20, hwnd, 0, 0, 0);
+            CreateWindowW(L"STATIC", L"Min Support:", WS_CHILD | WS_VISIBLE, 200, 60, 90, 20, hwnd, 0, 0, 0);
+            hMinSupportEntry = CreateWindowW(L"EDIT", L"1", WS_CHILD | WS_VISIBLE | WS_BORDER | ES_NUMBER, 290, 60, 50, 20, hwnd, 0, 0, 0);
             CreateWindowW(L"STATIC", L"Set Size:", WS_CHILD | WS_VISIBLE, 10, 100, 70, 20, hwnd, 0, 0, 0);
             int sizes[6] = {3, 4, 5, 6, 7, 8};
             for (int i = 0; i < 6; i++) {
@@ -339,9 +87,13 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp) {
                         break;
                     }
                 }
+                // Groups with a smaller Total are left out; empty or 0 keeps all
+                wchar_t support_buf[16];
+                GetWindowTextW(hMinSupportEntry, support_buf, 16);
+                int min_support = _wtoi(support_buf);
                 EnableWindow(hProcessBtn, FALSE); 
                 SetWindowTextW(hStatus, L"Processing...");
-                std::thread([=] { RunProcessing(buf, deg, set_size); }).detach();
+                std::thread([=] { ProcessFolder(buf, deg, set_size, min_support); }).detach();
             }
             else if (LOWORD(wp) >= 100 && LOWORD(wp) <= 105) {
                 // Handle radio button clicks
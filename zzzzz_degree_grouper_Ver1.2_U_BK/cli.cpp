@@ -0,0 +1,95 @@
+// Console front end of the degree grouper, for batch servers and cron.
+//
+// degree_grouper --input FILE --groups FILE --columns U,W,... [--output FILE]
+//                [--format csv|xlsx] [--quiet]
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include "../common/cli_args.h"
+#include "../common/console_progress.h"
+#include "../common/progress.h"
+#include "degree_grouper.h"
+
+namespace {
+
+const char* kUsage =
+    "Usage: degree_grouper --input FILE --groups FILE --columns LIST [options]\n"
+    "\n"
+    "Replaces the integers of the listed columns with the \"N-M\" range of the\n"
+    "groups file (one range per line) that holds them.\n"
+    "\n"
+    "  --columns LIST     comma separated, from U W Y AA AC ... BI BK\n"
+    "\n"
+    "Options:\n"
+    "  --output FILE      output file (default <input>_<columns>_Grouped.<format>)\n"
+    "  --format csv|xlsx  output format when --output is not given\n"
+#ifdef CSV_MANAGER_NO_XLSX
+    "                     (default csv)\n"
+#else
+    "                     (default xlsx)\n"
+#endif
+    "  --quiet            no progress on stderr\n";
+
+#ifdef CSV_MANAGER_NO_XLSX
+const char* kDefaultFormat = "csv";
+#else
+const char* kDefaultFormat = "xlsx";
+#endif
+
+// --columns in col_order order, like the GUI checkboxes
+std::vector<std::string> parseColumns(const std::string& list) {
+    std::set<std::string> wanted;
+    std::stringstream ss(list);
+    std::string col;
+    while (std::getline(ss, col, ',')) {
+        std::transform(col.begin(), col.end(), col.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        if (col.empty()) continue;
+        if (!col_num.count(col)) throw UsageError("Unknown column in --columns: " + col);
+        wanted.insert(col);
+    }
+    std::vector<std::string> selectedCols;
+    for (const auto& name : col_order) {
+        if (wanted.count(name)) selectedCols.push_back(name);
+    }
+    if (selectedCols.empty()) throw UsageError("--columns selects no column");
+    return selectedCols;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        CliArgs args(argc, argv, { "--input", "--groups", "--columns", "--output", "--format" }, { "--quiet" });
+        if (args.flag("--help")) {
+            std::cout << kUsage;
+            return 0;
+        }
+        std::filesystem::path excel_path = std::filesystem::u8path(args.require("--input"));
+        std::filesystem::path txt_path = std::filesystem::u8path(args.require("--groups"));
+        std::vector<std::string> selectedCols = parseColumns(args.require("--columns"));
+        std::filesystem::path output_path = args.has("--output")
+            ? std::filesystem::u8path(args.get("--output"))
+            : groupedOutputPath(excel_path, selectedCols, args.format(kDefaultFormat));
+
+        Progress progress;
+        progress.start();
+        ConsoleProgress reporter(progress, [](const Progress::Snapshot& shot) { return shot.status; }, !args.flag("--quiet"));
+        groupDegrees(excel_path, txt_path, selectedCols, output_path, progress);
+        progress.finish();
+        reporter.stop();
+
+        std::cout << "File saved to: " << output_path.u8string() << std::endl;
+        return 0;
+    }
+    catch (const UsageError& e) {
+        std::cerr << e.what() << "\n\n" << kUsage;
+        return 2;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
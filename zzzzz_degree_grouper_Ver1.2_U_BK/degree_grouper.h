@@ -0,0 +1,149 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <locale>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../common/csv_manager.h"
+#include "../common/numeric_parse.h"
+#include "../common/progress.h"
+
+// Grouping core shared by the Win32 GUI (main.cpp) and the console tool
+// (cli.cpp). Reports its stage through a Progress and throws on errors; it
+// never touches a window.
+
+// Column mapping from Python code - generate columns from U to BK in steps of 2
+// Python: col_letters = [get_column_letter(i) for i in range(start_col, end_col + 1, 2)]
+// where start_col = column_index_from_string('U') = 21, end_col = column_index_from_string('BK') = 63
+inline const std::vector<std::string> col_order = {
+    "U", "W", "Y", "AA", "AC", "AE", "AG", "AI", "AK", "AM", "AO", "AQ",
+    "AS", "AU", "AW", "AY", "BA", "BC", "BE", "BG", "BI", "BK"
+};
+
+inline const std::map<std::string, int> col_num = {
+    {"U", 21}, {"W", 23}, {"Y", 25}, {"AA", 27}, {"AC", 29}, {"AE", 31},
+    {"AG", 33}, {"AI", 35}, {"AK", 37}, {"AM", 39}, {"AO", 41}, {"AQ", 43},
+    {"AS", 45}, {"AU", 47}, {"AW", 49}, {"AY", 51}, {"BA", 53}, {"BC", 55},
+    {"BE", 57}, {"BG", 59}, {"BI", 61}, {"BK", 63}
+};
+
+// Range group holding intVal, or nullptr. Scanning stops at the first
+// malformed group, which also yields nullptr.
+inline const std::string* findRange(int intVal, const std::vector<std::string>& groupList) {
+    for (const auto& group : groupList) {
+        size_t dashPos = group.find('-');
+        if (dashPos != std::string::npos) {
+            std::string_view text(group);
+            int start = 0, end = 0;
+            if (!parseInt(text.substr(0, dashPos), start) || !parseInt(text.substr(dashPos + 1), end)) {
+                return nullptr;
+            }
+            if (start <= intVal && intVal <= end) {
+                return &group;
+            }
+        }
+    }
+    return nullptr;
+}
+
+// Helper function to map values to ranges (equivalent to Python's map_to_range)
+inline std::string mapToRange(const std::string& val, const std::vector<std::string>& groupList) {
+    int intVal = 0;
+    if (!parseInt(val, intVal)) {
+        // If conversion fails, return original value (same as Python)
+        return val;
+    }
+    if (const std::string* group = findRange(intVal, groupList)) {
+        return *group;
+    }
+    return val; // Return original value if no range matches
+}
+
+// Typed cells skip the text round trip; integer cells are mapped directly
+inline void mapToRange(TypedCell& cell, const std::vector<std::string>& groupList) {
+    if (!cell.isInt()) {
+        std::string mapped = mapToRange(cell.toString(), groupList);
+        cell.kind = TypedCell::Kind::Text;
+        cell.text = std::move(mapped);
+        return;
+    }
+    if (const std::string* group = findRange(cell.int_value, groupList)) {
+        cell.kind = TypedCell::Kind::Text;
+        cell.text = *group;
+    }
+}
+
+// Range groups from the TXT file, one "N-M" per line; blank lines are skipped
+inline std::vector<std::string> readGroups(const std::filesystem::path& txt_path) {
+    std::vector<std::string> groupList;
+    std::wifstream txtFile(txt_path);
+    txtFile.imbue(std::locale::classic());
+    if (!txtFile.is_open()) {
+        throw std::runtime_error("Cannot open TXT file!");
+    }
+    
+    std::wstring line;
+    while (std::getline(txtFile, line)) {
+        std::string trimmed = CSVManager::ws2s(line);
+        // Trim whitespace
+        trimmed.erase(0, trimmed.find_first_not_of(" \t"));
+        trimmed.erase(trimmed.find_last_not_of(" \t") + 1);
+        if (!trimmed.empty()) {
+            groupList.push_back(trimmed);
+        }
+    }
+    return groupList;
+}
+
+// Output next to the input: <input>_<columns>_Grouped.<format>
+inline std::filesystem::path groupedOutputPath(const std::filesystem::path& excel_path, const std::vector<std::string>& selectedCols, const std::string& format = "xlsx") {
+    std::string selectedColsStr;
+    for (const auto& col : selectedCols) {
+        selectedColsStr += col;
+    }
+    std::filesystem::path outputPath = excel_path;
+    outputPath.replace_extension();
+    outputPath += "_" + selectedColsStr + "_Grouped." + format;
+    return outputPath;
+}
+
+// Maps the integer cells of selectedCols (names from col_order) to the
+// range groups of txt_path and writes the sheet to outputPath (.csv or
+// .xlsx). Throws on errors.
+inline void groupDegrees(const std::filesystem::path& excel_path, const std::filesystem::path& txt_path,
+                         const std::vector<std::string>& selectedCols, const std::filesystem::path& outputPath,
+                         Progress& progress) {
+    if (selectedCols.empty()) {
+        throw std::runtime_error("Please select at least one column.");
+    }
+
+    progress.setStatus("Reading Excel file...");
+    TypedFrame df = CSVManager::readTyped(excel_path);
+
+    progress.setStatus("Reading TXT file...");
+    std::vector<std::string> groupList = readGroups(txt_path);
+
+    progress.setStatus("Processing data...");
+    
+    // Process selected columns
+    for (const auto& col : selectedCols) {
+        int colIndex = col_num.at(col) - 1; // Convert to 0-based index (Excel columns are 1-based)
+        if (colIndex >= 0) {
+            for (auto& row : df) {
+                if (colIndex < static_cast<int>(row.size())) {
+                    // Only process if the cell contains a numeric value
+                    if (row[colIndex].kind != TypedCell::Kind::Empty) {
+                        mapToRange(row[colIndex], groupList);
+                    }
+                }
+            }
+        }
+    }
+
+    progress.setStatus("Saving file...");
+    CSVManager::write(CSVManager::toDataFrame(df), outputPath);
+}
@@ -4,163 +4,13 @@
 #include <commctrl.h>
 #include <string>
 #include <vector>
-#include <iostream>
-#include <xlnt/xlnt.hpp>
-#include <fstream>
-#include <sstream>
 #include <algorithm>
 #include <filesystem>
 #include <map>
-#include <set>
 #include <thread>
-
-using Row = std::vector<std::string>;
-using DataFrame = std::vector<Row>;
-
-// Column mapping from Python code - generate columns from U to BK in steps of 2
-// Python: col_letters = [get_column_letter(i) for i in range(start_col, end_col + 1, 2)]
-// where start_col = column_index_from_string('U') = 21, end_col = column_index_from_string('BK') = 63
-std::vector<std::string> col_order = {
-    "U", "W", "Y", "AA", "AC", "AE", "AG", "AI", "AK", "AM", "AO", "AQ",
-    "AS", "AU", "AW", "AY", "BA", "BC", "BE", "BG", "BI", "BK"
-};
-
-std::map<std::string, int> col_num = {
-    {"U", 21}, {"W", 23}, {"Y", 25}, {"AA", 27}, {"AC", 29}, {"AE", 31},
-    {"AG", 33}, {"AI", 35}, {"AK", 37}, {"AM", 39}, {"AO", 41}, {"AQ", 43},
-    {"AS", 45}, {"AU", 47}, {"AW", 49}, {"AY", 51}, {"BA", 53}, {"BC", 55},
-    {"BE", 57}, {"BG", 59}, {"BI", 61}, {"BK", 63}
-};
-
-class CSVManager {
-public:
-    static DataFrame read(const std::wstring& filename) {
-        std::wstring ext = getExtension(filename);
-        if (ext == L".csv") {
-            return readCSVFile(filename);
-        }
-        else if (ext == L".xlsx") {
-            return readXLSXFile(filename);
-        }
-        else {
-            throw std::runtime_error("Unsupported file type");
-        }
-    }
-
-    static void write(const DataFrame& data, const std::wstring& filename) {
-        std::wstring ext = getExtension(filename);
-        if (ext == L".csv") {
-            writeCSVFile(data, filename);
-        }
-        else if (ext == L".xlsx") {
-            writeXLSXFile(data, filename);
-        }
-        else {
-            throw std::runtime_error("Unsupported file type");
-        }
-    }
-
-    static std::string ws2s(const std::wstring& wstr) {
-        int size_needed = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), (int)wstr.size(), NULL, 0, NULL, NULL);
-        std::string strTo(size_needed, 0);
-        WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), (int)wstr.size(), &strTo[0], size_needed, NULL, NULL);
-        return strTo;
-    }
-    
-    static std::wstring s2ws(const std::string& str) {
-        int size_needed = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), (int)str.size(), NULL, 0);
-        std::wstring wstrTo(size_needed, 0);
-        MultiByteToWideChar(CP_UTF8, 0, str.c_str(), (int)str.size(), &wstrTo[0], size_needed);
-        return wstrTo;
-    }
-
-private:
-    static std::wstring getExtension(const std::wstring& filename) {
-        size_t pos = filename.find_last_of(L'.');
-        if (pos == std::wstring::npos) return L"";
-        std::wstring ext = filename.substr(pos);
-        std::transform(ext.begin(), ext.end(), ext.begin(), ::towlower);
-        return ext;
-    }
-
-    static DataFrame readCSVFile(const std::wstring& filename) {
-        DataFrame data;
-        std::wifstream file(filename.c_str());
-        file.imbue(std::locale::classic());
-        if (!file.is_open()) {
-            throw std::runtime_error("Cannot open file");
-        }
-        std::wstring line;
-        while (std::getline(file, line)) {
-            Row row;
-            std::wstringstream ss(line);
-            std::wstring cell;
-            while (std::getline(ss, cell, L',')) {
-                // Remove quotes and trim whitespace
-                cell.erase(std::remove(cell.begin(), cell.end(), L'"'), cell.end());
-                cell.erase(0, cell.find_first_not_of(L" \t"));
-                cell.erase(cell.find_last_not_of(L" \t") + 1);
-                row.push_back(ws2s(cell));
-            }
-            if (!row.empty()) {
-                data.push_back(row);
-            }
-        }
-        return data;
-    }
-
-    static DataFrame readXLSXFile(const std::wstring& filename) {
-        DataFrame data;
-        xlnt::workbook wb;
-        wb.load(ws2s(filename));
-        auto ws = wb.active_sheet();
-        
-        // Read all rows (equivalent to pandas read_excel with header=None)
-        // Get the used range to ensure we read all data
-        auto range = ws.calculate_dimension();
-        for (auto row : ws.rows(false)) {
-            Row row_data;
-            for (auto cell : row) {
-                // Convert cell to string, handling empty cells properly
-                if (cell.has_value()) {
-                    row_data.push_back(cell.to_string());
-                } else {
-                    row_data.push_back(""); // Empty cell
-                }
-            }
-            data.push_back(row_data);
-        }
-        return data;
-    }
-
-    static void writeCSVFile(const DataFrame& data, const std::wstring& filename) {
-        std::wofstream file(filename.c_str());
-        file.imbue(std::locale::classic());
-        if (!file.is_open()) {
-            throw std::runtime_error("Cannot create file");
-        }
-        for (const auto& row : data) {
-            for (size_t i = 0; i < row.size(); ++i) {
-                if (i > 0) file << L",";
-                file << s2ws(row[i]);
-            }
-            file << L"\n";
-        }
-    }
-
-    static void writeXLSXFile(const DataFrame& data, const std::wstring& filename) {
-        xlnt::workbook wb;
-        auto ws = wb.active_sheet();
-        
-        // Write data without headers (equivalent to pandas to_excel with index=False, header=None)
-        for (size_t i = 0; i < data.size(); ++i) {
-            for (size_t j = 0; j < data[i].size(); ++j) {
-                ws.cell(static_cast<uint32_t>(j + 1), static_cast<uint32_t>(i + 1)).value(data[i][j]);
-            }
-        }
-        wb.save(ws2s(filename));
-    }
-};
+#include "../common/csv_manager.h"
+#include "../common/progress.h"
+#include "degree_grouper.h"
 
 // Global handles for GUI controls
 HWND hMainWindow;
@@ -178,28 +28,6 @@ void OnProcess();
 std::wstring OpenFileDialog(const wchar_t* filter);
 std::wstring OpenFolderDialog();
 
-// Helper function to map values to ranges (equivalent to Python's map_to_range)
-std::string mapToRange(const std::string& val, const std::vector<std::string>& groupList) {
-    try {
-        int intVal = std::stoi(val);
-        for (const auto& group : groupList) {
-            size_t dashPos = group.find('-');
-            if (dashPos != std::string::npos) {
-                int start = std::stoi(group.substr(0, dashPos));
-                int end = std::stoi(group.substr(dashPos + 1));
-                if (start <= intVal && intVal <= end) {
-                    return group;
-                }
-            }
-        }
-    }
-    catch (...) {
-        // If conversion fails, return original value (same as Python)
-        return val;
-    }
-    return val; // Return original value if no range matches
-}
-
 // Main processing logic
 void ProcessFile() {
     try {
@@ -213,29 +41,6 @@ void ProcessFile() {
             return;
         }
 
-        SetWindowTextW(hStatusText, L"Reading Excel file...");
-        DataFrame df = CSVManager::read(excel_path);
-
-        SetWindowTextW(hStatusText, L"Reading TXT file...");
-        std::vector<std::string> groupList;
-        std::wifstream txtFile(txt_path);
-        txtFile.imbue(std::locale::classic());
-        if (!txtFile.is_open()) {
-            MessageBoxW(hMainWindow, L"Cannot open TXT file!", L"Error", MB_OK | MB_ICONERROR);
-            return;
-        }
-        
-        std::wstring line;
-        while (std::getline(txtFile, line)) {
-            std::string trimmed = CSVManager::ws2s(line);
-            // Trim whitespace
-            trimmed.erase(0, trimmed.find_first_not_of(" \t"));
-            trimmed.erase(trimmed.find_last_not_of(" \t") + 1);
-            if (!trimmed.empty()) {
-                groupList.push_back(trimmed);
-            }
-        }
-
         // Get selected columns
         std::vector<std::string> selectedCols;
         for (const auto& col : col_order) {
@@ -252,40 +57,11 @@ void ProcessFile() {
         }
 
         SetWindowTextW(hStatusText, L"Processing data...");
+        std::filesystem::path outputPath = groupedOutputPath(excel_path, selectedCols);
+        Progress progress;
+        groupDegrees(excel_path, txt_path, selectedCols, outputPath, progress);
         
-        // Process selected columns
-        for (const auto& col : selectedCols) {
-            int colIndex = col_num[col] - 1; // Convert to 0-based index (Excel columns are 1-based)
-            if (colIndex >= 0) {
-                for (auto& row : df) {
-                    if (colIndex < static_cast<int>(row.size())) {
-                        // Only process if the cell contains a numeric value
-                        if (!row[colIndex].empty()) {
-                            row[colIndex] = mapToRange(row[colIndex], groupList);
-                        }
-                    }
-                }
-            }
-        }
-
-        // Generate output filename
-        std::wstring outputPath = excel_path;
-        size_t dotPos = outputPath.find_last_of(L'.');
-        if (dotPos != std::wstring::npos) {
-            outputPath = outputPath.substr(0, dotPos);
-        }
-        
-        std::string selectedColsStr;
-        for (const auto& col : selectedCols) {
-            selectedColsStr += col;
-        }
-        
-        outputPath += L"_" + CSVManager::s2ws(selectedColsStr) + L"_Grouped.xlsx";
-
-        SetWindowTextW(hStatusText, L"Saving file...");
-        CSVManager::write(df, outputPath);
-        
-        std::wstring successMsg = L"File saved to:\n" + outputPath;
+        std::wstring successMsg = L"File saved to:\n" + outputPath.wstring();
         SetWindowTextW(hStatusText, successMsg.c_str());
         MessageBoxW(hMainWindow, successMsg.c_str(), L"Success", MB_OK | MB_ICONINFORMATION);
     }